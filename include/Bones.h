@@ -2,6 +2,7 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 #include "Encode/EncodingManager.h"
 #include "openvr_driver.h"
@@ -9,20 +10,32 @@
 
 const short NUM_BONES = static_cast<short>(HandSkeletonBone::_Count);
 
+// angle (in degrees) a finger is rotated by at full splay
+static const float c_maxSplayAngle = 20.0f;
+
 class BoneAnimator {
  public:
-  explicit BoneAnimator(const std::string& fileName);
-  void ComputeSkeletonTransforms(vr::VRBoneTransform_t* skeleton, const VRInputData& inputData, const bool rightHand);
-  static void TransformLeftBone(vr::VRBoneTransform_t& bone, const HandSkeletonBone& boneIndex);
+  explicit BoneAnimator(const std::string& fileName, int bakeResolution = 0);
+  // update the bones of fingers whose input has changed since the last call, leaving the rest of the skeleton as the last call left it.
+  // controllerSkeleton, if given, gets the same bones for the with-controller range, so it should be passed on every call or none of them.
+  // Returns whether any bone was updated
+  bool ComputeSkeletonTransforms(
+      vr::VRBoneTransform_t* skeleton, vr::VRBoneTransform_t* controllerSkeleton, const VRInputData& inputData, const bool rightHand);
   static float GetAverageCurlValue(const std::array<float, 4>& joints);
+  // rotation of the splayed bone of a finger, for splay within -1 -> 1
+  static vr::HmdQuaternionf_t GetSplayRotation(float splay);
   void LoadDefaultSkeletonByHand(vr::VRBoneTransform_t* skeleton, const bool rightHand);
 
  private:
-  void SetTransformForBone(
-      vr::VRBoneTransform_t& bone, const HandSkeletonBone& boneIndex, const float curl, const float splay, const bool rightHand) const;
-
   std::string fileName_;
   std::unique_ptr<IModelManager> modelManager_;
   bool loaded_;
   std::vector<float> keyframes_;
+
+  // quantized flexion of each joint, then splay
+  using FingerInput = std::array<int32_t, 5>;
+
+  std::array<FingerInput, 5> lastFingerInputs_{};
+  bool lastFingerInputsValid_ = false;
+  bool lastRightHand_ = false;
 };
\ No newline at end of file
@@ -11,7 +11,7 @@
 #include "DeviceConfiguration.h"
 #include "Encode/EncodingManager.h"
 
-class BTSerialCommunicationManager : public CommunicationManager {
+class BTSerialCommunicationManager final : public CommunicationManager {
  public:
   BTSerialCommunicationManager(const VRCommunicationConfiguration& configuration, std::unique_ptr<EncodingManager> encodingManager);
 
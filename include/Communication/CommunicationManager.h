@@ -1,7 +1,7 @@
 #pragma once
 
 #include <atomic>
-#include <functional>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -9,20 +9,24 @@
 
 #include "DeviceConfiguration.h"
 #include "Encode/EncodingManager.h"
+#include "Util/Delegate.h"
+
+// Receives a decoded frame. The frame is only valid for the duration of the call
+using InputCallback = Delegate<void(const VRInputData&)>;
 
 class CommunicationManager {
  public:
   explicit CommunicationManager(VRCommunicationConfiguration configuration);
   CommunicationManager(VRCommunicationConfiguration configuration, std::unique_ptr<EncodingManager> encodingManager);
 
-  virtual void BeginListener(const std::function<void(VRInputData)>& callback);
+  virtual void BeginListener(InputCallback callback);
   virtual void Disconnect();
   virtual void QueueSend(const VROutput& data);
 
   virtual bool IsConnected() = 0;
 
  protected:
-  virtual void ListenerThread(const std::function<void(VRInputData)>& callback);
+  virtual void ListenerThread(InputCallback callback);
   virtual void WaitAttemptConnection();
 
   virtual bool Connect() = 0;
@@ -40,6 +44,12 @@ class CommunicationManager {
   std::atomic<bool> threadActive_;
   std::thread thread_;
 
+  // frames are decoded into here and handed to the callback by reference
+  VRInputData inputData_;
+
   std::mutex writeMutex_;
   std::string writeString_;
+
+  // set by ReceiveNextPacket when the first byte of a packet arrives
+  std::chrono::steady_clock::time_point packetArrivalTime_;
 };
\ No newline at end of file
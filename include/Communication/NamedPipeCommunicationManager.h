@@ -2,20 +2,23 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <memory>
 
 #include "Communication/CommunicationManager.h"
 #include "DeviceConfiguration.h"
 #include "Util/NamedPipeListener.h"
 
-class NamedPipeCommunicationManager : public CommunicationManager {
+enum class NamedPipeInputVersion : int { v1 = 0, v2, v3, _Count };
+
+class NamedPipeCommunicationManager final : public CommunicationManager {
  public:
   NamedPipeCommunicationManager(const VRCommunicationConfiguration& configuration);
   bool IsConnected() override;
 
   // no sending for named pipes
   void QueueSend(const VROutput& data) override{};
-  void BeginListener(const std::function<void(VRInputData)>& callback) override;
+  void BeginListener(InputCallback callback) override;
 
  protected:
   bool Connect() override;
@@ -32,9 +35,29 @@ class NamedPipeCommunicationManager : public CommunicationManager {
   };
 
  private:
+  void HandleInput(VRInputData& data) const;
+  void HandleBatch(const VRInputDataVersion::v3& data, const NamedPipeClient& client);
+
+  // what we know of the client sending batches on each pipe instance
+  struct BatchClient {
+    uint64_t connection = 0;
+    bool hasBatch = false;
+    uint32_t lastSequence = 0;
+    std::chrono::steady_clock::time_point lastSampleTime;
+
+    // time between its samples, zero until we know it
+    std::chrono::steady_clock::duration sampleInterval{};
+  };
+
   std::atomic<bool> isConnected_;
 
-  std::function<void(VRInputData)> callback_;
+  // only touched from the v3 listener's thread
+  std::array<BatchClient, c_namedPipeInstances> batchClients_;
+
+  InputCallback callback_;
+
+  // each version is read on its own thread, so each gets its own frame
+  std::array<VRInputData, static_cast<int>(NamedPipeInputVersion::_Count)> inputSlots_;
 
   VRCommunicationNamedPipeConfiguration namedPipeConfiguration_;
 
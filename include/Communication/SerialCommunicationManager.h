@@ -10,7 +10,7 @@
 #include "DeviceConfiguration.h"
 #include "Encode/EncodingManager.h"
 
-class SerialCommunicationManager : public CommunicationManager {
+class SerialCommunicationManager final : public CommunicationManager {
  public:
   SerialCommunicationManager(const VRCommunicationConfiguration& configuration, std::unique_ptr<EncodingManager> encodingManager);
 
@@ -1,11 +1,16 @@
 #pragma once
 #include <openvr_driver.h>
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 
 #include "Calibration.h"
 #include "ControllerDiscovery.h"
 #include "DeviceConfiguration.h"
+#include "PoseComposer.h"
+#include "PoseSnapshot.h"
 #include "Util/NamedPipeListener.h"
 
 struct CalibrationDataIn {
@@ -19,6 +24,10 @@ class ControllerPose {
 
   vr::DriverPose_t UpdatePose() const;
 
+  // raw pose of the controller we shadow, fetched again if the snapshot is older than maxAge, and when it was fetched
+  vr::TrackedDevicePose_t GetControllerPose(
+      std::chrono::steady_clock::duration maxAge, std::chrono::steady_clock::time_point* fetchTime = nullptr) const;
+
   void StartCalibration(CalibrationMethod method) const;
 
   void CompleteCalibration(CalibrationMethod method);
@@ -30,7 +39,14 @@ class ControllerPose {
  private:
   uint32_t shadowControllerId_ = vr::k_unTrackedDeviceIndexInvalid;
 
+  // the configuration as of the last calibration, and the composer built from it. Poses are composed on the publish thread while
+  // calibration completes on the input or calibration pipe thread, so a new composer is swapped in whole
   VRPoseConfiguration poseConfiguration_;
+  std::atomic<std::shared_ptr<const PoseComposer>> poseComposer_;
+  std::mutex calibrationMutex_;
+
+  // calibration doesn't change it, so it's read without the lock
+  const float poseTimeOffset_;
 
   vr::ETrackedControllerRole shadowDeviceOfRole_ = vr::TrackedControllerRole_Invalid;
 
@@ -40,6 +56,8 @@ class ControllerPose {
 
   bool IsRightHand() const;
 
+  std::shared_ptr<PoseSnapshot> poseSnapshot_;
+
   std::unique_ptr<ControllerDiscovery> controllerDiscoverer_;
   std::unique_ptr<NamedPipeListener<CalibrationDataIn>> calibrationPipe_;
   std::unique_ptr<Calibration> calibration_;
@@ -7,9 +7,12 @@
 #include "openvr_driver.h"
 
 extern const char* c_poseSettingsSection;
+extern const char* c_skeletonSettingsSection;
+extern const char* c_filterSettingsSection;
 extern const char* c_driverSettingsSection;
 extern const char* c_serialCommunicationSettingsSection;
 extern const char* c_btserialCommunicationSettingsSection;
+extern const char* c_namedPipeCommunicationSettingsSection;
 extern const char* c_knuckleDeviceSettingsSection;
 extern const char* c_lucidGloveDeviceSettingsSection;
 extern const char* c_alphaEncodingSettingsSection;
@@ -23,6 +26,13 @@ enum class VRCommunicationProtocol {
   NamedPipe,
 };
 
+// how input from multiple clients connected to the same named pipe is combined
+enum class VRNamedPipeArbitration {
+  LatestWriter = 0,
+  Priority = 1,
+  Merge = 2,
+};
+
 enum class VREncodingProtocol {
   Legacy = 0,
   Alpha = 1,
@@ -65,6 +75,7 @@ struct VRCommunicationBTSerialConfiguration {
 
 struct VRCommunicationNamedPipeConfiguration {
   std::string pipeName;
+  VRNamedPipeArbitration arbitration;
 
   bool operator==(const VRCommunicationNamedPipeConfiguration&) const = default;
 };
@@ -83,14 +94,62 @@ struct VRCommunicationConfiguration {
 struct VRPoseConfiguration {
   vr::HmdVector3d_t offsetVector;
   vr::HmdQuaternion_t angleOffsetQuaternion;
+
+  // time (in seconds, relative to when it's fetched) the controller's pose is predicted to, and the glove's pose is dated. Negative takes
+  // the controller's pose from the past and leaves the runtime to extrapolate the glove's further forward
   float poseTimeOffset;
   int controllerIdOverride;
   bool controllerOverrideEnabled;
   bool calibrationButtonEnabled;
 
+  // rate (in Hz) to publish the pose at, and the fastest it's published at while following the updates of the controller it shadows.
+  // Following the controller publishes each of its poses just after it updates, rather than at a fixed rate out of step with it
+  float publishRate;
+  bool publishOnControllerUpdate;
+
   bool operator==(const VRPoseConfiguration&) const = default;
 };
 
+struct VRSkeletonConfiguration {
+  // steps to pre-sample the animation into (16-4096), 0 to evaluate keyframes directly. If the keyframes are evenly spaced it's rounded up so
+  // that every keyframe lands on a step. The bundled animation is keyed every 1/24, so it bakes at 24n + 1 steps (256 becomes 265, 1024
+  // becomes 1033), and the resolution used is logged
+  int animationBakeResolution;
+
+  // longest time (in milliseconds) we go without updating the skeleton while the hand isn't moving, 0 to update it on every input
+  int heartbeatInterval;
+
+  // how far ahead of the newest input (in seconds) to extrapolate the fingers to, 0 to show them as they were measured. Alpha and beta are how
+  // much of the difference between where the predictor expected a finger and where it was measured corrects its position and speed
+  float predictionLead;
+  float predictionAlpha;
+  float predictionBeta;
+
+  // rate (in Hz) to publish the skeleton at from its own thread, 0 to publish it as input arrives. Publishing at the headset's refresh rate
+  // takes priority over the fixed rate while the headset reports one
+  float publishRate;
+  bool publishAtDisplayRate;
+
+  bool operator==(const VRSkeletonConfiguration&) const = default;
+};
+
+struct VRFilterConfiguration {
+  bool enabled;
+
+  // cutoff (in Hz) while a channel is still, and how much it rises for each unit per second the channel is moving
+  float flexionMinCutoff;
+  float flexionBeta;
+  float splayMinCutoff;
+  float splayBeta;
+  float joystickMinCutoff;
+  float joystickBeta;
+
+  // cutoff (in Hz) for the speed estimate the cutoffs are adapted from
+  float derivativeCutoff;
+
+  bool operator==(const VRFilterConfiguration&) const = default;
+};
+
 struct VRDeviceKnucklesConfiguration {
   bool indexCurlTrigger;
   bool approximateThumb;
@@ -112,6 +171,8 @@ struct VRDeviceConfiguration {
 
   VRPoseConfiguration poseConfiguration;
   VRCommunicationConfiguration communicationConfiguration;
+  VRSkeletonConfiguration skeletonConfiguration;
+  VRFilterConfiguration filterConfiguration;
 
   std::variant<VRDeviceKnucklesConfiguration, VRDeviceLucidglovesConfiguration> configuration;
 
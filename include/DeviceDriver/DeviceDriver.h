@@ -3,6 +3,7 @@
 #undef _WINSOCKAPI_
 #define _WINSOCKAPI_
 
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -11,6 +12,10 @@
 #include "ControllerPose.h"
 #include "DeviceConfiguration.h"
 #include "ForceFeedback.h"
+#include "InputFilter.h"
+#include "InputPredictor.h"
+#include "PosePublisher.h"
+#include "SkeletonPublisher.h"
 #include "openvr_driver.h"
 
 class DeviceDriver : public vr::ITrackedDeviceServerDriver {
@@ -38,19 +43,28 @@ class DeviceDriver : public vr::ITrackedDeviceServerDriver {
   virtual bool IsRightHand() const;
   virtual void StartDevice();
 
-  virtual void HandleInput(VRInputData data) = 0;
+  // offset (in seconds, negative for the past) from now to when the input was captured, for input component updates
+  static double GetInputTimeOffset(const VRInputData& data);
+
+  virtual void HandleInput(const VRInputData& data) = 0;
   virtual void SetupProps(vr::PropertyContainerHandle_t& props) = 0;
   virtual void StartingDevice() = 0;
   virtual void StoppingDevice() = 0;
-  void PoseUpdateThread() const;
 
  private:
+  void OnInput(const VRInputData& rawData);
+  vr::TrackedDevicePose_t GetControllerPose(std::chrono::steady_clock::duration maxAge, std::chrono::steady_clock::time_point* fetchTime);
+  void PublishPose();
+  void PublishSkeleton(const VRInputData& skeletonData);
   void SetupDeviceComponents();
   void StopDeviceComponents();
 
  protected:
   std::unique_ptr<CommunicationManager> communicationManager_;
   std::unique_ptr<BoneAnimator> boneAnimator_;
+  std::unique_ptr<InputFilter> inputFilter_;
+  std::unique_ptr<InputPredictor> inputPredictor_;
+  std::unique_ptr<SkeletonPublisher> skeletonPublisher_;
 
   VRDeviceConfiguration configuration_;
 
@@ -60,9 +74,15 @@ class DeviceDriver : public vr::ITrackedDeviceServerDriver {
   vr::VRInputComponentHandle_t skeletalComponentHandle_;
   vr::VRInputComponentHandle_t haptic_;
 
+  // frames the filter and predictor write into, kept so that input isn't copied onto the stack on every sample
+  VRInputData filteredData_;
+  VRInputData predictedData_;
+
   vr::VRBoneTransform_t handTransforms_[NUM_BONES];
+  vr::VRBoneTransform_t controllerHandTransforms_[NUM_BONES];
+  std::chrono::steady_clock::time_point lastSkeletonUpdateTime_;
 
-  std::thread poseUpdateThread_;
+  std::unique_ptr<PosePublisher> posePublisher_;
 
   std::atomic<bool> isRunning_;
   std::atomic<bool> isActive_;
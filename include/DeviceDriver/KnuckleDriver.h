@@ -36,11 +36,11 @@ enum class KnuckleDeviceComponentIndex : int {
   _Count
 };
 
-class KnuckleDeviceDriver : public DeviceDriver {
+class KnuckleDeviceDriver final : public DeviceDriver {
  public:
   KnuckleDeviceDriver(VRDeviceConfiguration configuration);
 
-  void HandleInput(VRInputData data) override;
+  void HandleInput(const VRInputData& data) override;
   void SetupProps(vr::PropertyContainerHandle_t& props) override;
   void StartingDevice() override;
   void StoppingDevice() override;
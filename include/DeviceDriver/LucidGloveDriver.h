@@ -27,11 +27,11 @@ enum class LucidGloveDeviceComponentIndex : int {
   _Count
 };
 
-class LucidGloveDeviceDriver : public DeviceDriver {
+class LucidGloveDeviceDriver final : public DeviceDriver {
  public:
   LucidGloveDeviceDriver(const VRDeviceConfiguration& configuration);
 
-  void HandleInput(VRInputData data) override;
+  void HandleInput(const VRInputData& data) override;
   void SetupProps(vr::PropertyContainerHandle_t& props) override;
   void StartingDevice() override;
   void StoppingDevice() override;
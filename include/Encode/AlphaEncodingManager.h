@@ -3,10 +3,10 @@
 #include "DeviceConfiguration.h"
 #include "Encode/EncodingManager.h"
 
-class AlphaEncodingManager : public EncodingManager {
+class AlphaEncodingManager final : public EncodingManager {
  public:
   explicit AlphaEncodingManager(const VREncodingConfiguration& configuration) : EncodingManager(configuration){};
 
-  VRInputData Decode(const std::string& input) override;
+  void Decode(const std::string& input, VRInputData& data) override;
   std::string Encode(const VROutput& input) override;
 };
\ No newline at end of file
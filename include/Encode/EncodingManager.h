@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -49,6 +51,21 @@ namespace VRInputDataVersion {
     // new
     float trgValue;
   };
+
+  static const uint32_t c_v3MaxSamples = 8;
+
+  // A batch of v2 samples, so that producers running faster than we read the pipe don't lose samples.
+  struct v3 {
+    uint32_t sequence;     // incremented by one for each message sent, used to detect dropped messages
+    uint32_t sampleCount;  // number of valid entries in samples (1 -> c_v3MaxSamples)
+    // time (in microseconds, on the QueryPerformanceCounter clock) at which the newest sample was taken, or 0 if the producer doesn't know
+    uint64_t timestamp;
+    // microseconds between consecutive samples, or 0 if the producer doesn't know (in which case it's measured from the batches)
+    uint32_t sampleInterval;
+
+    // oldest first
+    std::array<v2, c_v3MaxSamples> samples;
+  };
 }  // namespace VRInputDataVersion
 
 struct VRInputData : public VRInputDataVersion::v2 {
@@ -85,6 +102,15 @@ struct VRInputData : public VRInputDataVersion::v2 {
     calibrate = data.calibrate;
     trgValue = data.trgValue;
   }
+  // newest sample of the batch
+  VRInputData(const VRInputDataVersion::v3& data)
+      : VRInputData(data.samples[std::clamp<uint32_t>(data.sampleCount, 1, VRInputDataVersion::c_v3MaxSamples) - 1]) {}
+
+  // older samples of a batch are delivered with this unset. Consumers that only care about the current state can skip them
+  bool isLatestSample = true;
+
+  // when this sample was taken, or as close to that as we could observe
+  std::chrono::steady_clock::time_point timestamp;
 };
 
 // force feedback
@@ -133,7 +159,8 @@ class EncodingManager {
  public:
   explicit EncodingManager(VREncodingConfiguration configuration) : configuration_(std::move(configuration)){};
 
-  virtual VRInputData Decode(const std::string& input) = 0;
+  // decode into data, overwriting whatever frame it held. Everything but the timestamp is written, so that the caller can reuse one frame
+  virtual void Decode(const std::string& input, VRInputData& data) = 0;
   virtual std::string Encode(const VROutput& data) = 0;
 
  protected:
@@ -3,10 +3,10 @@
 #include "DeviceConfiguration.h"
 #include "Encode/EncodingManager.h"
 
-class LegacyEncodingManager : public EncodingManager {
+class LegacyEncodingManager final : public EncodingManager {
  public:
   explicit LegacyEncodingManager(const VREncodingConfiguration& configuration) : EncodingManager(configuration){};
 
-  VRInputData Decode(const std::string& input) override;
+  void Decode(const std::string& input, VRInputData& data) override;
   std::string Encode(const VROutput& input) override;
 };
\ No newline at end of file
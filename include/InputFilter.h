@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#include "DeviceConfiguration.h"
+#include "Encode/EncodingManager.h"
+
+// flexion of every joint, splay of every finger, then the joystick axes
+static const size_t c_inputFilterChannelCount = 27;
+
+// channels are processed 4 at a time, the padding lanes are never read back into the input
+static const size_t c_inputFilterLaneCount = (c_inputFilterChannelCount + 3) / 4 * 4;
+
+// One Euro filter (Casiez et al. 2012) over every analog channel of the input. While a channel is still its cutoff frequency sits at the
+// minimum, which hides sensor jitter, and rises with how fast the channel is moving so that motion isn't delayed.
+// Channels outside of -1 -> 1 (such as splay from a glove that doesn't report it) are passed through as they are, and start over when they
+// come back into range
+class InputFilter {
+ public:
+  explicit InputFilter(const VRFilterConfiguration& configuration);
+
+  // filter every sample in the order received, older samples of a batch included, so that the filter sees the true rate of change
+  void Filter(VRInputData& data);
+
+ private:
+  using Lanes = std::array<float, c_inputFilterLaneCount>;
+
+  // state and parameters for each channel, one array per field so that a vector register covers 4 channels
+  alignas(16) Lanes minCutoff_;
+  alignas(16) Lanes beta_;
+  alignas(16) Lanes value_;
+  alignas(16) Lanes derivative_;
+
+  float derivativeCutoff_;
+
+  // time between the last two samples that could be timed, used for any that can't
+  float sampleInterval_;
+  std::chrono::steady_clock::time_point lastTimestamp_;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#include "DeviceConfiguration.h"
+#include "Encode/EncodingManager.h"
+
+// flexion of every joint, then splay of every finger
+static const size_t c_inputPredictorChannelCount = 25;
+
+// alpha-beta tracker of the position and speed of every joint and splay, so that they can be extrapolated past the time they were measured to
+// make up for the time spent getting them to us. Channels outside of their valid range are passed through as they are, and start over when
+// they come back into range
+class InputPredictor {
+ public:
+  explicit InputPredictor(const VRSkeletonConfiguration& configuration);
+
+  // track every sample in the order received, older samples of a batch included
+  void Update(const VRInputData& data);
+
+  // extrapolate the tracked channels to targetTime, clamped to their valid range
+  void Predict(VRInputData& data, std::chrono::steady_clock::time_point targetTime) const;
+
+ private:
+  using Channels = std::array<float, c_inputPredictorChannelCount>;
+
+  Channels position_;
+  Channels velocity_;
+  std::array<bool, c_inputPredictorChannelCount> tracking_;
+
+  float alpha_;
+  float beta_;
+
+  // time between the last two samples that could be timed, used for any that can't
+  float sampleInterval_;
+  std::chrono::steady_clock::time_point lastTimestamp_;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "DeviceConfiguration.h"
+#include "Util/SimdMath.h"
+#include "openvr_driver.h"
+
+// Builds the pose of a glove from the pose of the controller it's attached to, in one pass over the controller's matrix. The offset only
+// changes when the glove is calibrated, so its rotation is turned into a matrix once rather than on every pose. Calibrating builds a new
+// composer rather than changing this one, as poses are composed on another thread
+class PoseComposer {
+ public:
+  explicit PoseComposer(const VRPoseConfiguration& configuration);
+
+  // the pose of the glove for a valid controller pose, which was the controller's pose poseTimeOffset seconds from when the glove's is
+  // published. The glove's velocity includes the controller turning about it, so the runtime can extrapolate it to when it's shown
+  vr::DriverPose_t Compose(const vr::TrackedDevicePose_t& controllerPose, float poseTimeOffset) const;
+
+ private:
+  const vr::HmdVector3d_t offsetPosition_;
+  const vr::HmdQuaternion_t offsetRotation_;
+
+  // rotation of the offset, to take angular velocity from the controller's space into the glove's
+  const Mat3x4f offsetRotationMatrix_;
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#include "DeviceConfiguration.h"
+#include "Util/Delegate.h"
+#include "openvr_driver.h"
+
+// raw pose of the controller the glove follows, fetched again if the one we have is older than the given age, and when it was fetched
+using ControllerPoseSource = Delegate<vr::TrackedDevicePose_t(std::chrono::steady_clock::duration, std::chrono::steady_clock::time_point*)>;
+using PoseCallback = Delegate<void()>;
+
+// Publishes the glove's pose from its own thread, just after the controller it follows updates. The runtime doesn't tell a driver when
+// another driver's device moves, so we watch for the controller's pose changing to learn its update rate, then lock a timer to it that wakes
+// once per update, with a closer look every few updates to keep it in phase. Without an update rate to follow (no controller, one that isn't
+// tracking, or one updating faster than we publish), or when asked to, the pose is published at a fixed rate instead
+class PosePublisher {
+ public:
+  PosePublisher(const VRPoseConfiguration& configuration, ControllerPoseSource controllerPoseSource, PoseCallback callback);
+  ~PosePublisher();
+
+  void Start();
+  void Stop();
+
+  // whether two fetches of the controller's pose, b elapsed seconds after a, come from the same update of the controller
+  static bool IsSamePose(const vr::TrackedDevicePose_t& a, const vr::TrackedDevicePose_t& b, float elapsed);
+
+ private:
+  void PublishThread();
+
+  // sleeps until the given time, returning false if we were stopped first
+  bool WaitUntil(std::chrono::steady_clock::time_point wakeTime);
+
+  // each returns when to wake next
+  std::chrono::steady_clock::time_point OnFixedRateWake(std::chrono::steady_clock::time_point now, bool poseChanged);
+  std::chrono::steady_clock::time_point OnSearchWake(std::chrono::steady_clock::time_point now, bool poseChanged);
+  std::chrono::steady_clock::time_point OnLockedWake(std::chrono::steady_clock::time_point now, bool poseChanged);
+
+  // fetches the controller's pose, and returns whether it changed since the last poll
+  bool PollControllerPose(std::chrono::steady_clock::time_point now, std::chrono::steady_clock::duration maxAge);
+
+  // corrects the expected update time and the update period from the time an update was seen at
+  void ObserveUpdate(std::chrono::steady_clock::time_point updateTime);
+
+  // moves on to the controller's next update, returning when to wake for it
+  std::chrono::steady_clock::time_point ScheduleNextUpdate();
+
+  void StartSearch(std::chrono::steady_clock::time_point now);
+  void UseFixedRate(std::chrono::steady_clock::time_point now, std::chrono::steady_clock::time_point nextSearch);
+
+  void Publish(std::chrono::steady_clock::time_point now);
+
+  // tracks publishes, wakeups, how late they were and pose age, and logs them every so often
+  void RecordPublish(std::chrono::steady_clock::time_point now);
+
+  enum class SyncState {
+    FixedRate,
+    Searching,
+    Locked,
+  };
+
+  bool publishOnControllerUpdate_;
+  std::chrono::steady_clock::duration publishInterval_;
+
+  ControllerPoseSource controllerPoseSource_;
+  PoseCallback callback_;
+
+  SyncState syncState_;
+
+  // the controller's pose as of the last update we saw and when it was fetched, and our best guess at when it changed to it (the middle of
+  // the window between the polls either side of the change)
+  vr::TrackedDevicePose_t controllerPose_;
+  std::chrono::steady_clock::time_point controllerPoseFetchTime_;
+  std::chrono::steady_clock::time_point lastPollTime_;
+  std::chrono::steady_clock::time_point poseChangeTime_;
+  std::chrono::steady_clock::duration poseChangeWindow_;
+
+  std::chrono::steady_clock::time_point nextFixedPublish_;
+  std::chrono::steady_clock::time_point nextSearch_;
+  std::chrono::steady_clock::time_point searchStart_;
+  std::chrono::steady_clock::time_point firstSearchUpdate_;
+  int searchUpdates_;
+
+  // the controller's update cadence while locked to it
+  std::chrono::steady_clock::duration updatePeriod_;
+  std::chrono::steady_clock::time_point expectedUpdate_;
+  int updatesSinceObservation_;
+  int missedUpdates_;
+  bool lastUpdateMissed_;
+  bool measureNext_;
+  bool isMeasuring_;
+  bool isWaitingForUpdate_;
+
+  // telemetry since it was last logged
+  std::chrono::steady_clock::time_point lastPublishTime_;
+  std::chrono::steady_clock::time_point lastTelemetryTime_;
+  uint64_t publishCount_;
+  uint64_t wakeupCount_;
+  double wakeLatenessSum_;
+  double maxWakeLateness_;
+  double poseAgeSum_;
+  double maxPoseAge_;
+
+#if defined(_WIN32)
+  HANDLE waitTimer_;
+  HANDLE stopEvent_;
+#else
+  std::mutex mutex_;
+  std::condition_variable stopCondition_;
+#endif
+  std::atomic<bool> isRunning_;
+  std::thread publishThread_;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+#include "openvr_driver.h"
+
+// The raw pose of every tracked device, fetched at most once a tick however many gloves read it, and published with a seqlock so that
+// readers copy out the device they shadow without taking a lock. One snapshot is shared by every glove
+class PoseSnapshot {
+ public:
+  // the shared snapshot, made on first use and freed once nothing holds it
+  static std::shared_ptr<PoseSnapshot> Get();
+
+  PoseSnapshot();
+
+  // the pose of one device, fetching every device's pose first if the snapshot is more than a tick old, and when it was fetched. Invalid
+  // for indices out of range
+  vr::TrackedDevicePose_t GetPose(uint32_t deviceIndex, std::chrono::steady_clock::time_point* fetchTime = nullptr);
+
+  // as above, fetching first if the snapshot is older than maxAge
+  vr::TrackedDevicePose_t GetPose(
+      uint32_t deviceIndex, std::chrono::steady_clock::duration maxAge, std::chrono::steady_clock::time_point* fetchTime = nullptr);
+
+  // fetch every device's pose, unless the snapshot is younger than maxAge
+  void Refresh(std::chrono::steady_clock::duration maxAge = {});
+
+  // how far from when they're fetched (in seconds) the runtime predicts the poses to. It's the same for both gloves, as it comes from the
+  // pose settings they share
+  void SetPredictionTime(float predictionTime);
+
+ private:
+  // poses are copied in and out a word at a time with atomics, as a reader can copy while the writer is part way through, and checks
+  // afterwards whether it has to try again
+  static constexpr size_t c_poseWords = sizeof(vr::TrackedDevicePose_t) / sizeof(uint32_t);
+  static_assert(sizeof(vr::TrackedDevicePose_t) % sizeof(uint32_t) == 0);
+
+  using PoseWords = std::array<std::atomic<uint32_t>, c_poseWords>;
+
+  std::chrono::steady_clock::duration GetAge() const;
+  void Publish(std::chrono::steady_clock::time_point fetchTime);
+
+  // odd while the poses, and the time they were fetched at, are being written
+  std::atomic<uint32_t> sequence_;
+  std::array<PoseWords, vr::k_unMaxTrackedDeviceCount> poses_;
+  std::atomic<std::chrono::steady_clock::rep> fetchTime_;
+
+  std::atomic<float> predictionTime_;
+
+  // held by the thread fetching poses, which is the only one that writes them
+  std::mutex refreshMutex_;
+  vr::TrackedDevicePose_t fetchedPoses_[vr::k_unMaxTrackedDeviceCount];
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "DeviceConfiguration.h"
+#include "Encode/EncodingManager.h"
+#include "InputPredictor.h"
+#include "Util/Delegate.h"
+
+using SkeletonCallback = Delegate<void(const VRInputData&)>;
+
+// Publishes the skeleton on its own thread at a fixed rate, or at the headset's refresh rate, rather than whenever input arrives. Each output
+// is interpolated between the two newest samples (shown one input interval behind, so that there is always a sample either side of it), or
+// extrapolated with the predictor when a prediction lead is set. A glove slower than the publish rate then moves smoothly between its samples,
+// and one faster than it no longer updates the runtime on every sample
+class SkeletonPublisher {
+ public:
+  SkeletonPublisher(const VRSkeletonConfiguration& configuration, SkeletonCallback callback);
+  ~SkeletonPublisher();
+
+  // hand over a sample from the input thread, older samples of a batch included
+  void Submit(const VRInputData& data);
+
+  void Start();
+  void Stop();
+
+ private:
+  void PublishThread();
+
+  // sample to show at time, interpolated or extrapolated from the samples received so far. Called with the lock held
+  VRInputData GetSampleAt(std::chrono::steady_clock::time_point time) const;
+
+  // how long until the next publish, following the headset's refresh rate if we've been asked to
+  std::chrono::steady_clock::duration GetPublishInterval(std::chrono::steady_clock::time_point now);
+
+  // tracks how far the time between publishes strays from the target, and logs it every so often
+  void RecordPublish(std::chrono::steady_clock::time_point time, std::chrono::steady_clock::duration targetInterval);
+
+  VRSkeletonConfiguration configuration_;
+  SkeletonCallback callback_;
+
+  std::unique_ptr<InputPredictor> inputPredictor_;
+
+  // the two newest samples that were taken far enough apart to be timed, and when they were taken
+  std::mutex mutex_;
+  std::condition_variable stopCondition_;
+  VRInputData previousSample_;
+  VRInputData latestSample_;
+  std::chrono::steady_clock::time_point previousSampleTime_;
+  std::chrono::steady_clock::time_point latestSampleTime_;
+  bool hasSample_;
+
+  float displayFrequency_;
+  std::chrono::steady_clock::time_point lastDisplayFrequencyQuery_;
+
+  // publish interval telemetry since it was last logged
+  std::chrono::steady_clock::time_point lastPublishTime_;
+  std::chrono::steady_clock::time_point lastTelemetryTime_;
+  uint64_t publishCount_;
+  double intervalSum_;
+  double intervalErrorSquareSum_;
+  double maxIntervalError_;
+  double targetIntervalSum_;
+
+  std::atomic<bool> isRunning_;
+  std::thread publishThread_;
+};
@@ -1,13 +1,14 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
 
 #include "openvr_driver.h"
 
-#define TINYGLTF_NO_STB_IMAGE
-#define TINYGLTF_NO_STB_IMAGE_WRITE
-#include "tiny_gltf.h"
-
 enum class HandSkeletonBone : vr::BoneIndex_t {
   Root = 0,
   Wrist,
@@ -49,49 +50,184 @@ struct Transform {
   std::array<float, 3> translation;
 };
 
-struct AnimationData {
-  AnimationData();
-  Transform startTransform;
-  float startTime;
-  Transform endTransform;
-  float endTime;
+static const size_t c_animationBoneCount = static_cast<size_t>(HandSkeletonBone::_Count);
+
+// animations are authored for the right hand, and mirrored for the left hand once when they're loaded, so that evaluating either hand is the
+// same work. The right hand comes first
+static const size_t c_animationHandCount = 2;
+
+// the range of motion an animation is for, in the same order as vr::EVRSkeletalMotionRange. Models without an animation for holding a
+// controller use their open hand animation for both
+enum class AnimationRange : size_t {
+  WithoutController = 0,
+  WithController = 1,
+};
+
+static const size_t c_animationRangeCount = 2;
+
+// name of the animation in a model to use while holding a controller. The first of the other animations is used without one
+static const char* c_controllerAnimationName = "with_controller";
+
+// floats per bone per keyframe. Translations are padded with a w of 1 so that both halves of a bone fill a 4 wide vector register, and
+// interpolate straight into a vr::VRBoneTransform_t
+static const size_t c_keyframeRotationStride = 4;
+static const size_t c_keyframeTranslationStride = 4;
+
+// models with STEP or CUBICSPLINE channels store the cubic c0 + c1 t + c2 t^2 + c3 t^3 from each keyframe to the next, in place of the value at
+// each keyframe. Linear channels are exact in this form too, so a model that mixes them is evaluated the same way for every bone
+static const size_t c_hermiteCoefficientCount = 4;
+
+// rotations read from normalised 8 or 16 bit integers are kept that way, as 16 bit integers of each component times this, in place of floats.
+// That halves their size, and as rotations are normalised after interpolating anyway they're never scaled back down
+static const float c_rotationQuantizationScale = 32767.0f;
+
+// the pair of keyframes a point in the animation falls between, and how far between them it is
+struct KeyframeInterval {
+  size_t lowerIndex;
+  size_t upperIndex;
+  float interp;
 };
 
+// animation data extracted from a model. Immutable once loaded, so one copy is shared by every device animating from the same file
+struct AnimationModel {
+  // every bone of the right hand, then every bone of the left hand
+  std::vector<Transform> initialTransforms;
+  std::span<const float> keyframeTimes;
+
+  // a keyframe set for each hand of each range the model has an animation for (see GetKeyframeSet). Each set is the rotations (wxyz) for every
+  // bone of every keyframe, followed by the translations (xyz1) for every bone of every keyframe. Every range shares the keyframe times, so
+  // one keyframe search serves all of them
+  std::span<const float> keyframeData;
+
+  // if not empty, the rotations of every keyframe set quantized to 16 bits (see c_rotationQuantizationScale), and each set in keyframeData only
+  // has the translations. Only models that interpolate linearly are quantized
+  std::span<const int16_t> quantizedRotations;
+
+  // 1 if the model only has an animation for the open hand, which is then used for every range
+  size_t rangeCount = 1;
+
+  // 1 if every keyframe holds the value of the bone there, interpolated linearly to the next. c_hermiteCoefficientCount if it holds the
+  // coefficients of the cubic to the next keyframe, one after another, with the last keyframe's holding it where it is
+  size_t coefficientCount = 1;
+
+  // keyframe times are evenly spaced from 0 to 1, so the interval for a time can be computed directly
+  bool baked = false;
+
+  // what the spans point into, either vectors the animation was extracted into or a mapping of a precompiled animation file
+  std::shared_ptr<const void> storage;
+
+  KeyframeInterval GetKeyframeInterval(float f) const;
+  // see IModelManager::GetTransforms, for every bone
+  void GetTransforms(
+      const KeyframeInterval* intervals, bool rightHand, vr::VRBoneTransform_t* transforms, vr::VRBoneTransform_t* controllerTransforms) const;
+  void GetTransforms(
+      std::span<const size_t> bones,
+      const KeyframeInterval* intervals,
+      bool rightHand,
+      vr::VRBoneTransform_t* transforms,
+      vr::VRBoneTransform_t* controllerTransforms) const;
+  const Transform& GetInitialTransform(size_t bone, bool rightHand) const;
+  size_t GetMemoryUsage() const;
+
+  static size_t GetHandIndex(bool rightHand) {
+    return static_cast<size_t>(!rightHand);
+  }
+  static size_t GetKeyframeSet(AnimationRange range, bool rightHand) {
+    return static_cast<size_t>(range) * c_animationHandCount + GetHandIndex(rightHand);
+  }
+
+  // floats per bone per keyframe that rotations take in each set of keyframeData, none if they're quantized
+  static size_t GetKeyframeRotationSize(size_t coefficientCount, bool quantizedRotations) {
+    return quantizedRotations ? 0 : c_keyframeRotationStride * coefficientCount;
+  }
+  static size_t GetKeyframeSetSize(size_t keyframeCount, size_t coefficientCount, bool quantizedRotations) {
+    return keyframeCount * c_animationBoneCount *
+           (GetKeyframeRotationSize(coefficientCount, quantizedRotations) + c_keyframeTranslationStride * coefficientCount);
+  }
+  static size_t GetKeyframeDataSize(size_t keyframeCount, size_t rangeCount, size_t coefficientCount, bool quantizedRotations) {
+    return rangeCount * c_animationHandCount * GetKeyframeSetSize(keyframeCount, coefficientCount, quantizedRotations);
+  }
+  static size_t GetKeyframeRotationIndex(size_t keyframeCount, size_t coefficientCount, size_t set, size_t keyframe, size_t bone) {
+    return set * GetKeyframeSetSize(keyframeCount, coefficientCount, false) +
+           (keyframe * c_animationBoneCount + bone) * c_keyframeRotationStride * coefficientCount;
+  }
+  static size_t GetKeyframeTranslationIndex(
+      size_t keyframeCount, size_t coefficientCount, bool quantizedRotations, size_t set, size_t keyframe, size_t bone) {
+    return set * GetKeyframeSetSize(keyframeCount, coefficientCount, quantizedRotations) +
+           keyframeCount * c_animationBoneCount * GetKeyframeRotationSize(coefficientCount, quantizedRotations) +
+           (keyframe * c_animationBoneCount + bone) * c_keyframeTranslationStride * coefficientCount;
+  }
+  static size_t GetQuantizedRotationsSize(size_t keyframeCount, size_t rangeCount) {
+    return rangeCount * c_animationHandCount * keyframeCount * c_animationBoneCount * c_keyframeRotationStride;
+  }
+  static size_t GetQuantizedRotationIndex(size_t keyframeCount, size_t set, size_t keyframe, size_t bone) {
+    return ((set * keyframeCount + keyframe) * c_animationBoneCount + bone) * c_keyframeRotationStride;
+  }
+
+  const float* GetKeyframeRotation(size_t set, size_t keyframe, size_t bone) const {
+    return &keyframeData[GetKeyframeRotationIndex(keyframeTimes.size(), coefficientCount, set, keyframe, bone)];
+  }
+  const int16_t* GetQuantizedKeyframeRotation(size_t set, size_t keyframe, size_t bone) const {
+    return &quantizedRotations[GetQuantizedRotationIndex(keyframeTimes.size(), set, keyframe, bone)];
+  }
+  const float* GetKeyframeTranslation(size_t set, size_t keyframe, size_t bone) const {
+    return &keyframeData[GetKeyframeTranslationIndex(keyframeTimes.size(), coefficientCount, !quantizedRotations.empty(), set, keyframe, bone)];
+  }
+};
+
+// extract the animations of a .glb file, nullptr if it couldn't be loaded
+std::shared_ptr<AnimationModel> LoadGLTFAnimationModel(const std::string& fileName);
+
+// largest difference in any rotation or translation component between the baked and keyframed animation that we accept
+static const float c_maxBakeError = 1e-3f;
+
+// the animation of a model sampled at evenly spaced times and interpolated linearly between them, whether its own keyframes were linear or
+// cubic, or nullptr if the samples aren't accurate enough to replace the keyframes. If the keyframes are evenly spaced the resolution is
+// rounded up to the next that puts a step on every keyframe, which is logged, and the baked model has that many keyframe times
+std::shared_ptr<AnimationModel> BakeAnimationModel(const AnimationModel& model, int resolution);
+
 class IModelManager {
  public:
+  virtual ~IModelManager() = default;
+
   virtual bool Load() = 0;
 
-  virtual AnimationData GetAnimationDataByBoneIndex(const HandSkeletonBone& boneIndex, float f) const = 0;
-  virtual Transform GetTransformByBoneIndex(const HandSkeletonBone& boneIndex) const = 0;
+  virtual KeyframeInterval GetKeyframeInterval(float f) const = 0;
+
+  // evaluate the listed bones of the animation in one pass, each at its own interval, into their entries of transforms, leaving the rest as
+  // they are. All arrays have c_animationBoneCount entries. Rotations are normalised and take the shortest path between keyframes. The
+  // with-controller range is evaluated at the same intervals into controllerTransforms, unless it's nullptr
+  virtual void GetTransforms(
+      std::span<const size_t> bones,
+      const KeyframeInterval* intervals,
+      bool rightHand,
+      vr::VRBoneTransform_t* transforms,
+      vr::VRBoneTransform_t* controllerTransforms) const = 0;
+  virtual Transform GetTransformByBoneIndex(const HandSkeletonBone& boneIndex, bool rightHand) const = 0;
 };
 
 class GLTFModelManager : public IModelManager {
  public:
-  GLTFModelManager(std::string fileName) : fileName_(std::move(fileName)) {}
+  // bakeResolution resamples the animation at that many evenly spaced times, so that finding the keyframes for a time doesn't need a search
+  explicit GLTFModelManager(std::string fileName, int bakeResolution = 0) : fileName_(std::move(fileName)), bakeResolution_(bakeResolution) {}
 
+  // models are cached by file and modification time for as long as any manager holds them, so only the first load for a file reads it.
+  // A precompiled animation next to the model is mapped in place of parsing it, as long as it was converted from the same file
   bool Load() override;
 
-  AnimationData GetAnimationDataByBoneIndex(const HandSkeletonBone& boneIndex, const float f) const override;
-  Transform GetTransformByBoneIndex(const HandSkeletonBone& boneIndex) const;
-
- private:
-  void LoadInitialTransforms();
-  void LoadKeyframeTimes();
-
-  template <size_t N>
-  std::vector<std::array<float, N>> GetVecN(const tinygltf::Accessor& accessor) const {
-    const tinygltf::BufferView bufferView = model_.bufferViews[accessor.bufferView];
-    const std::vector<unsigned char>& bufData = model_.buffers[0].data;
+  KeyframeInterval GetKeyframeInterval(float f) const override;
 
-    std::vector<std::array<float, N>> res(accessor.count);
-    memcpy(&res[0], bufData.data() + bufferView.byteOffset + accessor.byteOffset, accessor.count * sizeof(float) * N);
+  void GetTransforms(
+      std::span<const size_t> bones,
+      const KeyframeInterval* intervals,
+      bool rightHand,
+      vr::VRBoneTransform_t* transforms,
+      vr::VRBoneTransform_t* controllerTransforms) const override;
+  Transform GetTransformByBoneIndex(const HandSkeletonBone& boneIndex, bool rightHand) const override;
 
-    return res;
-  }
-
-  tinygltf::Model model_;
+ private:
   std::string fileName_;
-  std::vector<Transform> initialTransforms_;
-  std::vector<float> keyframeTimes_;
-  std::vector<std::vector<Transform>> keyframeTransforms_;
+  int bakeResolution_;
+
+  std::shared_ptr<const AnimationModel> model_;
 };
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Util/AnimLoader.h"
+
+// precompiled animations are read straight out of a mapping of the file, so the driver doesn't parse the model they came from at startup.
+// Any change to the layout of the file needs a new version, files written with another version are ignored
+static const char* c_animationBlobExtension = ".ogab";
+static const uint32_t c_animationBlobVersion = 6;
+
+// every section of the file starts on a boundary of this many bytes, so keyframes can be loaded with aligned vector loads
+static const size_t c_animationBlobAlignment = 64;
+
+// where the precompiled animation for a model is kept, next to it with c_animationBlobExtension in place of its own
+std::string GetAnimationBlobPath(const std::string& modelFileName);
+
+// write a model to a precompiled animation, recording sourceFileName as the file it was converted from
+bool WriteAnimationBlob(const std::string& fileName, const AnimationModel& model, const std::string& sourceFileName);
+
+// map a precompiled animation. nullptr if there isn't one, or it's corrupt, from another version, or wasn't converted from sourceFileName as
+// it is now. sourceFileName is only read if it was modified since it was converted
+std::shared_ptr<AnimationModel> LoadAnimationBlob(const std::string& fileName, const std::string& sourceFileName);
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <utility>
+
+template <typename Signature>
+class Delegate;
+
+// A non-owning, non-allocating callable bound to a member function of an object. Calling it costs a single indirect call.
+// The bound object must outlive the delegate.
+template <typename R, typename... Args>
+class Delegate<R(Args...)> {
+ public:
+  Delegate() = default;
+
+  template <typename T, R (T::*Method)(Args...)>
+  static Delegate FromMethod(T* instance) {
+    return Delegate(instance, [](void* object, Args... args) -> R { return (static_cast<T*>(object)->*Method)(std::forward<Args>(args)...); });
+  }
+
+  R operator()(Args... args) const {
+    return function_(instance_, std::forward<Args>(args)...);
+  }
+
+  explicit operator bool() const {
+    return function_ != nullptr;
+  }
+
+ private:
+  Delegate(void* instance, R (*function)(void*, Args...)) : instance_(instance), function_(function) {}
+
+  void* instance_ = nullptr;
+  R (*function_)(void*, Args...) = nullptr;
+};
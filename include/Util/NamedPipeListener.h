@@ -3,16 +3,35 @@
 #include <Windows.h>
 
 #include <atomic>
+#include <cstring>
 #include <functional>
 #include <string>
 #include <thread>
+#include <vector>
 
+#include "DeviceConfiguration.h"
 #include "DriverLog.h"
 #include "Util/Windows.h"
 
 static const int c_namedPipeDelay = 5;
 
-enum class NamedPipeListenerState { Connecting, Reading, Callback };
+// number of pipe instances kept open, each of which can serve one client at a time
+static const int c_namedPipeInstances = 4;
+
+// a higher priority client that hasn't written for this long no longer blocks lower priority clients
+static const ULONGLONG c_namedPipePriorityTimeout = 500;
+
+// longest to wait for cancelled pipe operations to complete when the listener stops
+static const DWORD c_namedPipeDrainTimeout = 1000;
+
+enum class NamedPipeListenerState { Connecting, Reading };
+
+// where a message came from: the pipe instance it was read from, and the connection to that instance, which changes each time a client
+// connects
+struct NamedPipeClient {
+  size_t instance;
+  uint64_t connection;
+};
 
 class IListener {
  public:
@@ -24,18 +43,50 @@ template <typename T>
 struct NamedPipeListenerData {
   OVERLAPPED oOverlap;
   HANDLE hPipeInst;
+  ULONG_PTR completionKey;
+
+  // an overlapped operation is in flight, or a completion packet was posted for this instance without one. Either way one packet is still
+  // to come out of the port
   bool fPendingIO;
+  bool fCompletionPosted;
   NamedPipeListenerState state;
-  DWORD dwBytesRead;
-  std::function<void(T*)> callback;
+
+  // order in which this client connected, lower connected earlier (and so has higher priority)
+  uint64_t connectionSequence;
+  ULONGLONG lastMessageTime;
+  bool hasMessage;
+
   char chRequest[sizeof(T)];
+  char chLastMessage[sizeof(T)];
 };
 
 template <typename T>
 class NamedPipeListener : public IListener {
  public:
-  explicit NamedPipeListener(std::string pipeName, const std::function<void(T*)>& callback)
-      : pipeName_(std::move(pipeName)), callback_(callback), threadActive_(false), IListener() {}
+  explicit NamedPipeListener(
+      std::string pipeName,
+      const std::function<void(T*)>& callback,
+      const VRNamedPipeArbitration arbitration = VRNamedPipeArbitration::LatestWriter,
+      const std::function<void(const std::vector<const T*>&)>& mergeCallback = nullptr)
+      : NamedPipeListener(
+            std::move(pipeName),
+            std::function<void(T*, const NamedPipeClient&)>([callback](T* data, const NamedPipeClient&) { callback(data); }),
+            arbitration,
+            mergeCallback) {}
+
+  // as above, for callbacks that keep track of each client
+  NamedPipeListener(
+      std::string pipeName,
+      const std::function<void(T*, const NamedPipeClient&)>& callback,
+      const VRNamedPipeArbitration arbitration = VRNamedPipeArbitration::LatestWriter,
+      const std::function<void(const std::vector<const T*>&)>& mergeCallback = nullptr)
+      : IListener(),
+        pipeName_(std::move(pipeName)),
+        threadActive_(false),
+        hPort_(nullptr),
+        callback_(callback),
+        mergeCallback_(mergeCallback),
+        arbitration_(arbitration) {}
   ~NamedPipeListener() {
     StopListening();
   }
@@ -66,17 +117,20 @@ class NamedPipeListener : public IListener {
 
  private:
   bool Connect(NamedPipeListenerData<T>* data) {
+    data->state = NamedPipeListenerState::Connecting;
+    data->hasMessage = false;
+
     if (!ConnectNamedPipe(data->hPipeInst, &data->oOverlap)) {
       switch (GetLastError()) {
         case ERROR_IO_PENDING:
+          // the port is notified when a client connects
           data->fPendingIO = true;
-          data->state = NamedPipeListenerState::Connecting;
           return true;
 
         case ERROR_PIPE_CONNECTED:
-          if (SetEvent(data->oOverlap.hEvent)) {
-            data->fPendingIO = false;
-            data->state = NamedPipeListenerState::Reading;
+          // a client connected before we started waiting, no completion packet is queued for this so post one ourselves
+          if (PostQueuedCompletionStatus(hPort_, 0, data->completionKey, &data->oOverlap)) {
+            data->fCompletionPosted = true;
             return true;
           }
           break;
@@ -85,7 +139,6 @@ class NamedPipeListener : public IListener {
 
     LogError("Failed to connect");
     data->fPendingIO = false;
-    data->state = NamedPipeListenerState::Reading;
 
     return false;
   }
@@ -95,97 +148,175 @@ class NamedPipeListener : public IListener {
 
     if (!Connect(data)) LogError("Error reconnecting to pipe from disconnect");
   }
-  void ListenerThread() {
-    HANDLE hEvent = CreateEventA(nullptr, TRUE, TRUE, nullptr);
-    if (hEvent == nullptr) {
-      LogError("CreateEvent failed");
+  void Read(NamedPipeListenerData<T>* data) {
+    // completion is posted to the port whether the read finishes synchronously or not
+    if (ReadFile(data->hPipeInst, data->chRequest, sizeof(T), nullptr, &data->oOverlap) || GetLastError() == ERROR_IO_PENDING) {
+      data->fPendingIO = true;
       return;
     }
 
-    HANDLE hPipeInst = CreateNamedPipeA(
-        pipeName_.c_str(),              // pipe name
-        PIPE_ACCESS_DUPLEX |            // read/write access
-            FILE_FLAG_OVERLAPPED,       // overlapped mode
-        PIPE_TYPE_MESSAGE |             // message-type pipe
-            PIPE_READMODE_MESSAGE |     // message read mode
-            PIPE_WAIT,                  // blocking mode
-        PIPE_UNLIMITED_INSTANCES,       // unlimited instances
-        static_cast<DWORD>(sizeof(T)),  // output buffer size
-        static_cast<DWORD>(sizeof(T)),  // input buffer size
-        c_namedPipeDelay,               // client time-out
-        nullptr);                       // default security attributes
-    if (hPipeInst == INVALID_HANDLE_VALUE) {
-      LogError("CreateNamedPipe failed");
-      CloseHandle(hEvent);
+    LogError("Pipe received data but failed to read");
+    DisconnectAndReconnect(data);
+  }
+  void Dispatch(const std::vector<NamedPipeListenerData<T>>& instances, NamedPipeListenerData<T>& source) {
+    switch (arbitration_) {
+      case VRNamedPipeArbitration::Priority: {
+        for (const auto& instance : instances) {
+          if (instance.state != NamedPipeListenerState::Reading || !instance.hasMessage) continue;
+          if (source.lastMessageTime - instance.lastMessageTime > c_namedPipePriorityTimeout) continue;
+
+          // another client that connected before this one is still writing
+          if (instance.connectionSequence < source.connectionSequence) return;
+        }
+
+        break;
+      }
+
+      case VRNamedPipeArbitration::Merge: {
+        if (mergeCallback_ == nullptr) break;
+
+        mergeMessages_.clear();
+        for (const auto& instance : instances) {
+          if (instance.state != NamedPipeListenerState::Reading || !instance.hasMessage) continue;
+
+          // a client that's still connected but has stopped writing shouldn't hold its last input in the merge
+          if (source.lastMessageTime - instance.lastMessageTime > c_namedPipePriorityTimeout) continue;
+
+          mergeMessages_.push_back(reinterpret_cast<const T*>(instance.chLastMessage));
+        }
+
+        mergeCallback_(mergeMessages_);
+        return;
+      }
+
+      default:
+        break;
+    }
+
+    callback_((T*)source.chLastMessage, {source.completionKey, source.connectionSequence});
+  }
+  void ListenerThread() {
+    hPort_ = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (hPort_ == nullptr) {
+      LogError("CreateIoCompletionPort failed");
       return;
     }
 
-    NamedPipeListenerData<T> listenerData{};
-    listenerData.oOverlap.hEvent = hEvent;
-    listenerData.hPipeInst = hPipeInst;
+    std::vector<NamedPipeListenerData<T>> instances(c_namedPipeInstances);
+    mergeMessages_.reserve(c_namedPipeInstances);
+
+    for (size_t i = 0; i < instances.size(); i++) {
+      NamedPipeListenerData<T>& instance = instances[i];
+      instance.completionKey = i;
+
+      instance.hPipeInst = CreateNamedPipeA(
+          pipeName_.c_str(),              // pipe name
+          PIPE_ACCESS_DUPLEX |            // read/write access
+              FILE_FLAG_OVERLAPPED,       // overlapped mode
+          PIPE_TYPE_MESSAGE |             // message-type pipe
+              PIPE_READMODE_MESSAGE |     // message read mode
+              PIPE_WAIT,                  // blocking mode
+          PIPE_UNLIMITED_INSTANCES,       // unlimited instances
+          static_cast<DWORD>(sizeof(T)),  // output buffer size
+          static_cast<DWORD>(sizeof(T)),  // input buffer size
+          c_namedPipeDelay,               // client time-out
+          nullptr);                       // default security attributes
+      if (instance.hPipeInst == INVALID_HANDLE_VALUE) {
+        LogError("CreateNamedPipe failed");
+        continue;
+      }
+
+      if (CreateIoCompletionPort(instance.hPipeInst, hPort_, instance.completionKey, 0) == nullptr) {
+        LogError("Failed to associate pipe with completion port");
+        CloseHandle(instance.hPipeInst);
+        instance.hPipeInst = INVALID_HANDLE_VALUE;
+        continue;
+      }
+
+      Connect(&instance);
+    }
 
-    if (!Connect(&listenerData)) return;
+    LogMessage("Successfully created pipe instances");
 
-    LogMessage("Successfully connected to pipe");
+    uint64_t connectionCount = 0;
     while (threadActive_) {
-      switch (const DWORD dwWaitResult = WaitForSingleObject(listenerData.oOverlap.hEvent, c_namedPipeDelay)) {
-        case WAIT_OBJECT_0:
-          break;
-        case WAIT_TIMEOUT:
-          continue;
-        default:
-          LogError("WaitForSingleObject failed");
-          DisconnectAndReconnect(&listenerData);
-          continue;
+      DWORD dwBytesTransferred = 0;
+      ULONG_PTR completionKey = 0;
+      OVERLAPPED* pOverlapped = nullptr;
+      const BOOL fSuccess = GetQueuedCompletionStatus(hPort_, &dwBytesTransferred, &completionKey, &pOverlapped, c_namedPipeDelay);
+
+      if (pOverlapped == nullptr) {
+        if (GetLastError() != WAIT_TIMEOUT) LogError("GetQueuedCompletionStatus failed");
+        continue;
       }
 
-      if (listenerData.fPendingIO) {
-        DWORD dwBytesTransferred = 0;
-        const BOOL fSuccess = GetOverlappedResult(listenerData.hPipeInst, &listenerData.oOverlap, &dwBytesTransferred, FALSE);
-        if (listenerData.state == NamedPipeListenerState::Reading) {
-          if (!fSuccess || dwBytesTransferred == 0) {
-            LogError("GetOverlappedResult failed");
-            DisconnectAndReconnect(&listenerData);
-            continue;
-          }
-          listenerData.fPendingIO = false;
-          listenerData.state = NamedPipeListenerState::Callback;
-          listenerData.dwBytesRead = dwBytesTransferred;
-        } else {  // Connecting/Callback/etc.
-          if (!fSuccess) {
-            LogError("GetOverlappedResult failed");
-            break;
-          }
-          listenerData.state = NamedPipeListenerState::Reading;
-        }
+      NamedPipeListenerData<T>& instance = instances[completionKey];
+      instance.fPendingIO = false;
+      instance.fCompletionPosted = false;
+
+      if (!fSuccess) {
+        // client went away, or sent a message that isn't the size we expect
+        DisconnectAndReconnect(&instance);
+        continue;
       }
 
-      if (listenerData.state == NamedPipeListenerState::Reading) {
-        if (ReadFile(listenerData.hPipeInst, listenerData.chRequest, sizeof(T), &listenerData.dwBytesRead, &listenerData.oOverlap)) {
-          if (listenerData.dwBytesRead > 0) {
-            listenerData.fPendingIO = false;
-            listenerData.state = NamedPipeListenerState::Callback;
-          } else
-            DisconnectAndReconnect(&listenerData);
-        } else {
-          if (GetLastError() == ERROR_IO_PENDING)
-            listenerData.fPendingIO = true;
-          else {
-            LogError("Pipe received data but failed to read");
-            DisconnectAndReconnect(&listenerData);
-          }
+      if (instance.state == NamedPipeListenerState::Connecting) {
+        LogMessage("Client connected to pipe");
+        instance.state = NamedPipeListenerState::Reading;
+        instance.connectionSequence = connectionCount++;
+      } else {
+        if (dwBytesTransferred != sizeof(T)) {
+          DisconnectAndReconnect(&instance);
+          continue;
         }
-      } else {  // Callback (see above)
-        if (listenerData.dwBytesRead == sizeof(T)) {
-          callback_((T*)listenerData.chRequest);
-          listenerData.state = NamedPipeListenerState::Reading;
-        } else
-          DisconnectAndReconnect(&listenerData);
+
+        memcpy(instance.chLastMessage, instance.chRequest, sizeof(T));
+        instance.hasMessage = true;
+        instance.lastMessageTime = GetTickCount64();
+
+        Dispatch(instances, instance);
+      }
+
+      Read(&instance);
+    }
+
+    for (auto& instance : instances) {
+      if (instance.hPipeInst == INVALID_HANDLE_VALUE) continue;
+
+      CancelIoEx(instance.hPipeInst, nullptr);
+    }
+
+    // cancelled operations still queue a completion packet, as do the ones we posted, so drain the port of them before their buffers go away
+    size_t outstanding = 0;
+    for (const auto& instance : instances) {
+      if (instance.fPendingIO || instance.fCompletionPosted) outstanding++;
+    }
+
+    while (outstanding > 0) {
+      DWORD dwBytesTransferred = 0;
+      ULONG_PTR completionKey = 0;
+      OVERLAPPED* pOverlapped = nullptr;
+      GetQueuedCompletionStatus(hPort_, &dwBytesTransferred, &completionKey, &pOverlapped, c_namedPipeDrainTimeout);
+
+      if (pOverlapped == nullptr) {
+        LogError("Timed out waiting for cancelled pipe operations");
+        break;
       }
+
+      NamedPipeListenerData<T>& instance = instances[completionKey];
+      if (!instance.fPendingIO && !instance.fCompletionPosted) continue;
+
+      instance.fPendingIO = false;
+      instance.fCompletionPosted = false;
+      outstanding--;
+    }
+
+    for (auto& instance : instances) {
+      if (instance.hPipeInst != INVALID_HANDLE_VALUE) CloseHandle(instance.hPipeInst);
     }
 
-    CloseHandle(hPipeInst);
-    CloseHandle(hEvent);
+    CloseHandle(hPort_);
+    hPort_ = nullptr;
   }
 
   const std::string pipeName_;
@@ -193,5 +324,11 @@ class NamedPipeListener : public IListener {
   std::atomic<bool> threadActive_;
   std::thread thread_;
 
-  std::function<void(T*)> callback_;
-};
\ No newline at end of file
+  HANDLE hPort_;
+
+  std::function<void(T*, const NamedPipeClient&)> callback_;
+  std::function<void(const std::vector<const T*>&)> mergeCallback_;
+  std::vector<const T*> mergeMessages_;
+
+  VRNamedPipeArbitration arbitration_;
+};
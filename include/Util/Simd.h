@@ -0,0 +1,11 @@
+#pragma once
+
+// OPENGLOVE_SIMD_SSE or OPENGLOVE_SIMD_NEON is defined when vector kernels can use that instruction set. OPENGLOVE_NO_SIMD forces the scalar
+// paths, which the vector paths should match to within float rounding
+#if !defined(OPENGLOVE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define OPENGLOVE_SIMD_SSE
+#include <emmintrin.h>
+#elif !defined(OPENGLOVE_NO_SIMD) && (defined(__aarch64__) || defined(_M_ARM64))
+#define OPENGLOVE_SIMD_NEON
+#include <arm_neon.h>
+#endif
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+#include "Util/Simd.h"
+#include "openvr_driver.h"
+
+// float quaternion, vector and matrix math with each value in one 4 wide register. Quaternions are wxyz like the openvr types, vectors are xyz
+// with a w of 0, and matrices are the three rows of a rotation and translation like vr::HmdMatrix34_t. Values are converted from and to the
+// openvr types where they come in and go out, and stay in float in between. Without SIMD the same operations run on 4 floats one at a time
+
+#if defined(OPENGLOVE_SIMD_SSE)
+using Float4 = __m128;
+#elif defined(OPENGLOVE_SIMD_NEON)
+using Float4 = float32x4_t;
+#else
+struct Float4 {
+  float v[4];
+};
+#endif
+
+inline Float4 Float4Set(const float x, const float y, const float z, const float w) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_setr_ps(x, y, z, w);
+#elif defined(OPENGLOVE_SIMD_NEON)
+  const float values[4] = {x, y, z, w};
+  return vld1q_f32(values);
+#else
+  return {{x, y, z, w}};
+#endif
+}
+
+inline Float4 Float4Load(const float* values) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_loadu_ps(values);
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vld1q_f32(values);
+#else
+  return {{values[0], values[1], values[2], values[3]}};
+#endif
+}
+
+inline void Float4Store(float* values, const Float4 a) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  _mm_storeu_ps(values, a);
+#elif defined(OPENGLOVE_SIMD_NEON)
+  vst1q_f32(values, a);
+#else
+  std::copy_n(a.v, 4, values);
+#endif
+}
+
+inline Float4 Float4Splat(const float value) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_set1_ps(value);
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vdupq_n_f32(value);
+#else
+  return {{value, value, value, value}};
+#endif
+}
+
+inline Float4 Float4Add(const Float4 a, const Float4 b) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_add_ps(a, b);
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vaddq_f32(a, b);
+#else
+  return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+#endif
+}
+
+inline Float4 Float4Sub(const Float4 a, const Float4 b) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_sub_ps(a, b);
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vsubq_f32(a, b);
+#else
+  return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+#endif
+}
+
+inline Float4 Float4Mul(const Float4 a, const Float4 b) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_mul_ps(a, b);
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vmulq_f32(a, b);
+#else
+  return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+#endif
+}
+
+// every lane set to lane Lane of a
+template <int Lane>
+inline Float4 Float4Broadcast(const Float4 a) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_shuffle_ps(a, a, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vdupq_laneq_f32(a, Lane);
+#else
+  return {{a.v[Lane], a.v[Lane], a.v[Lane], a.v[Lane]}};
+#endif
+}
+
+// the lanes of a in the order 1 0 3 2
+inline Float4 Float4SwapPairs(const Float4 a) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vrev64q_f32(a);
+#else
+  return {{a.v[1], a.v[0], a.v[3], a.v[2]}};
+#endif
+}
+
+// the lanes of a in the order 2 3 0 1
+inline Float4 Float4SwapHalves(const Float4 a) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 3, 2));
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vextq_f32(a, a, 2);
+#else
+  return {{a.v[2], a.v[3], a.v[0], a.v[1]}};
+#endif
+}
+
+// the lanes of a in the order 3 2 1 0
+inline Float4 Float4Reverse(const Float4 a) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 1, 2, 3));
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vrev64q_f32(vextq_f32(a, a, 2));
+#else
+  return {{a.v[3], a.v[2], a.v[1], a.v[0]}};
+#endif
+}
+
+// the lanes of a in the order 1 2 0 3, which turns xyz into yzx
+inline Float4 Float4RotateXYZ(const Float4 a) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vcopyq_laneq_f32(vcopyq_laneq_f32(vextq_f32(a, a, 1), 2, a, 0), 3, a, 3);
+#else
+  return {{a.v[1], a.v[2], a.v[0], a.v[3]}};
+#endif
+}
+
+// the lanes of a moved down one, with 0 shifted into the top
+inline Float4 Float4ShiftDown(const Float4 a) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(a), 4));
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vextq_f32(a, vdupq_n_f32(0.0f), 1);
+#else
+  return {{a.v[1], a.v[2], a.v[3], 0.0f}};
+#endif
+}
+
+// the dot product of a and b in every lane
+inline Float4 Float4Dot(const Float4 a, const Float4 b) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  __m128 dot = _mm_mul_ps(a, b);
+  dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(1, 0, 3, 2)));
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vdupq_n_f32(vaddvq_f32(vmulq_f32(a, b)));
+#else
+  return Float4Splat(a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2] + a.v[3] * b.v[3]);
+#endif
+}
+
+// 1 / sqrt(a) in every lane, to float precision
+inline Float4 Float4InvSqrt(const Float4 a) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  // the estimate is good to 12 bits, one newton-raphson step brings it to float precision
+  const __m128 estimate = _mm_rsqrt_ps(a);
+  return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), estimate), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_mul_ps(a, estimate), estimate)));
+#elif defined(OPENGLOVE_SIMD_NEON)
+  // the estimate is good to 8 bits, two newton-raphson steps bring it to float precision
+  float32x4_t estimate = vrsqrteq_f32(a);
+  estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(a, estimate), estimate));
+  return vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(a, estimate), estimate));
+#else
+  return {{1.0f / std::sqrt(a.v[0]), 1.0f / std::sqrt(a.v[1]), 1.0f / std::sqrt(a.v[2]), 1.0f / std::sqrt(a.v[3])}};
+#endif
+}
+
+// a / sqrt(b) in every lane, correctly rounded like the scalar operations, so it matches them exactly
+inline Float4 Float4DivSqrt(const Float4 a, const Float4 b) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_div_ps(a, _mm_sqrt_ps(b));
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vdivq_f32(a, vsqrtq_f32(b));
+#else
+  return {{a.v[0] / std::sqrt(b.v[0]), a.v[1] / std::sqrt(b.v[1]), a.v[2] / std::sqrt(b.v[2]), a.v[3] / std::sqrt(b.v[3])}};
+#endif
+}
+
+inline Float4 Float4Max(const Float4 a, const Float4 b) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  return _mm_max_ps(a, b);
+#elif defined(OPENGLOVE_SIMD_NEON)
+  return vmaxq_f32(a, b);
+#else
+  return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}};
+#endif
+}
+
+struct Quatf {
+  Float4 wxyz;
+};
+
+struct Vec3f {
+  Float4 xyz0;
+};
+
+struct Mat3x4f {
+  Float4 rows[3];
+};
+
+inline Quatf ToQuatf(const vr::HmdQuaternion_t& q) {
+  return {Float4Set(static_cast<float>(q.w), static_cast<float>(q.x), static_cast<float>(q.y), static_cast<float>(q.z))};
+}
+inline Quatf ToQuatf(const vr::HmdQuaternionf_t& q) {
+  return {Float4Load(&q.w)};
+}
+inline vr::HmdQuaternion_t ToHmdQuaternion(const Quatf q) {
+  float wxyz[4];
+  Float4Store(wxyz, q.wxyz);
+  return {wxyz[0], wxyz[1], wxyz[2], wxyz[3]};
+}
+inline vr::HmdQuaternionf_t ToHmdQuaternionf(const Quatf q) {
+  vr::HmdQuaternionf_t result;
+  Float4Store(&result.w, q.wxyz);
+  return result;
+}
+
+inline Vec3f ToVec3f(const vr::HmdVector3_t& v) {
+  return {Float4Set(v.v[0], v.v[1], v.v[2], 0.0f)};
+}
+inline Vec3f ToVec3f(const vr::HmdVector3d_t& v) {
+  return {Float4Set(static_cast<float>(v.v[0]), static_cast<float>(v.v[1]), static_cast<float>(v.v[2]), 0.0f)};
+}
+inline vr::HmdVector3d_t ToHmdVector3d(const Vec3f v) {
+  float xyz0[4];
+  Float4Store(xyz0, v.xyz0);
+  return {xyz0[0], xyz0[1], xyz0[2]};
+}
+
+// from and into the double[3] vectors of vr::DriverPose_t
+inline Vec3f LoadVec3(const double* v) {
+  return {Float4Set(static_cast<float>(v[0]), static_cast<float>(v[1]), static_cast<float>(v[2]), 0.0f)};
+}
+inline void StoreVec3(const Vec3f v, double* result) {
+  float xyz0[4];
+  Float4Store(xyz0, v.xyz0);
+  std::copy_n(xyz0, 3, result);
+}
+
+inline Mat3x4f ToMat3x4f(const vr::HmdMatrix34_t& m) {
+  return {{Float4Load(m.m[0]), Float4Load(m.m[1]), Float4Load(m.m[2])}};
+}
+inline vr::HmdMatrix34_t ToHmdMatrix34(const Mat3x4f& m) {
+  vr::HmdMatrix34_t result;
+  for (int row = 0; row < 3; row++) Float4Store(result.m[row], m.rows[row]);
+  return result;
+}
+
+inline Vec3f operator+(const Vec3f a, const Vec3f b) {
+  return {Float4Add(a.xyz0, b.xyz0)};
+}
+inline Vec3f operator-(const Vec3f a, const Vec3f b) {
+  return {Float4Sub(a.xyz0, b.xyz0)};
+}
+inline Vec3f operator*(const Vec3f a, const float b) {
+  return {Float4Mul(a.xyz0, Float4Splat(b))};
+}
+
+inline Vec3f Cross(const Vec3f a, const Vec3f b) {
+  // a * b.yzx - a.yzx * b is the cross product, one lane around
+  const Float4 rotated = Float4Sub(Float4Mul(a.xyz0, Float4RotateXYZ(b.xyz0)), Float4Mul(Float4RotateXYZ(a.xyz0), b.xyz0));
+  return {Float4RotateXYZ(rotated)};
+}
+
+// the hamilton product, so (a * b) rotates by b and then by a. Summed over the components of b, each against a shuffled and signed to line
+// up with it
+inline Quatf operator*(const Quatf a, const Quatf b) {
+  Float4 result = Float4Mul(Float4Broadcast<0>(b.wxyz), a.wxyz);
+  result = Float4Add(result, Float4Mul(Float4Broadcast<1>(b.wxyz), Float4Mul(Float4SwapPairs(a.wxyz), Float4Set(-1.0f, 1.0f, 1.0f, -1.0f))));
+  result = Float4Add(result, Float4Mul(Float4Broadcast<2>(b.wxyz), Float4Mul(Float4SwapHalves(a.wxyz), Float4Set(-1.0f, -1.0f, 1.0f, 1.0f))));
+  result = Float4Add(result, Float4Mul(Float4Broadcast<3>(b.wxyz), Float4Mul(Float4Reverse(a.wxyz), Float4Set(-1.0f, 1.0f, -1.0f, 1.0f))));
+  return {result};
+}
+
+// the inverse rotation of a unit quaternion
+inline Quatf Conjugate(const Quatf q) {
+  return {Float4Mul(q.wxyz, Float4Set(1.0f, -1.0f, -1.0f, -1.0f))};
+}
+
+inline Quatf Normalize(const Quatf q) {
+  return {Float4Mul(q.wxyz, Float4InvSqrt(Float4Max(Float4Dot(q.wxyz, q.wxyz), Float4Splat(1e-12f))))};
+}
+
+// v rotated by the unit quaternion q, as v + 2w (q x v) + 2 q x (q x v), without building a quaternion from v
+inline Vec3f Rotate(const Quatf q, const Vec3f v) {
+  const Vec3f axis = {Float4ShiftDown(q.wxyz)};
+  const Vec3f t = Cross(axis, v) * 2.0f;
+
+  return {Float4Add(Float4Add(v.xyz0, Float4Mul(Float4Broadcast<0>(q.wxyz), t.xyz0)), Cross(axis, t).xyz0)};
+}
+
+// v rotated by the inverse of the unit quaternion q
+inline Vec3f InverseRotate(const Quatf q, const Vec3f v) {
+  return Rotate(Conjugate(q), v);
+}
+
+// the matrix that rotates by the unit quaternion q and then translates by translation, straight from the components of q
+inline Mat3x4f ToMat3x4f(const Quatf q, const Vec3f translation) {
+  float wxyz[4];
+  float t[4];
+  Float4Store(wxyz, q.wxyz);
+  Float4Store(t, translation.xyz0);
+
+  const float w = wxyz[0], x = wxyz[1], y = wxyz[2], z = wxyz[3];
+  const float x2 = x + x, y2 = y + y, z2 = z + z;
+  const float xx = x * x2, yy = y * y2, zz = z * z2;
+  const float xy = x * y2, xz = x * z2, yz = y * z2;
+  const float wx = w * x2, wy = w * y2, wz = w * z2;
+
+  return {
+      {Float4Set(1.0f - yy - zz, xy - wz, xz + wy, t[0]),
+       Float4Set(xy + wz, 1.0f - xx - zz, yz - wx, t[1]),
+       Float4Set(xz - wy, yz + wx, 1.0f - xx - yy, t[2])}};
+}
+
+// p rotated and translated by m
+inline Vec3f TransformPoint(const Mat3x4f& m, const Vec3f p) {
+  const Float4 point = Float4Add(p.xyz0, Float4Set(0.0f, 0.0f, 0.0f, 1.0f));
+
+  float x[4], y[4], z[4];
+  Float4Store(x, Float4Dot(m.rows[0], point));
+  Float4Store(y, Float4Dot(m.rows[1], point));
+  Float4Store(z, Float4Dot(m.rows[2], point));
+  return {Float4Set(x[0], y[0], z[0], 0.0f)};
+}
+
+// d rotated by m, without its translation
+inline Vec3f TransformDirection(const Mat3x4f& m, const Vec3f d) {
+  float x[4], y[4], z[4];
+  Float4Store(x, Float4Dot(m.rows[0], d.xyz0));
+  Float4Store(y, Float4Dot(m.rows[1], d.xyz0));
+  Float4Store(z, Float4Dot(m.rows[2], d.xyz0));
+  return {Float4Set(x[0], y[0], z[0], 0.0f)};
+}
+
+// d rotated by the inverse of the rotation of m, which is its transpose, as a sum of the rows of m
+inline Vec3f InverseTransformDirection(const Mat3x4f& m, const Vec3f d) {
+  Float4 result = Float4Mul(m.rows[0], Float4Broadcast<0>(d.xyz0));
+  result = Float4Add(result, Float4Mul(m.rows[1], Float4Broadcast<1>(d.xyz0)));
+  result = Float4Add(result, Float4Mul(m.rows[2], Float4Broadcast<2>(d.xyz0)));
+
+  // the rows carry the translation in w
+  return {Float4Mul(result, Float4Set(1.0f, 1.0f, 1.0f, 0.0f))};
+}
+
+// the matrix gives 4 q q^T: 4 w^2, 4 x^2... from sums along its diagonal, 4 wx, 4 wy, 4 wz from its antisymmetric part and 4 xy, 4 xz,
+// 4 yz from its symmetric part. A row of 4 q q^T is one component of q times 4 q, so dividing it by 2 sqrt of its diagonal gives q with one
+// square root. Two comparisons pick a row whose diagonal is at least 1 (not always the largest, which takes three, but as well conditioned),
+// so it stays accurate near 180 degrees where w is close to 0. Writes that row, and returns its diagonal signed like its w, so that the
+// quaternions that come out all have a positive w
+inline float GetRotationRow(const vr::HmdMatrix34_t& matrix, Float4& row) {
+  const float(&m)[3][4] = matrix.m;
+
+  if (m[2][2] < 0.0f) {
+    if (m[0][0] > m[1][1]) {
+      const float diagonal = 1.0f + m[0][0] - m[1][1] - m[2][2];
+      row = Float4Set(m[2][1] - m[1][2], diagonal, m[0][1] + m[1][0], m[0][2] + m[2][0]);
+      return std::copysign(diagonal, m[2][1] - m[1][2]);
+    }
+
+    const float diagonal = 1.0f - m[0][0] + m[1][1] - m[2][2];
+    row = Float4Set(m[0][2] - m[2][0], m[0][1] + m[1][0], diagonal, m[1][2] + m[2][1]);
+    return std::copysign(diagonal, m[0][2] - m[2][0]);
+  }
+
+  if (m[0][0] < -m[1][1]) {
+    const float diagonal = 1.0f - m[0][0] - m[1][1] + m[2][2];
+    row = Float4Set(m[1][0] - m[0][1], m[0][2] + m[2][0], m[1][2] + m[2][1], diagonal);
+    return std::copysign(diagonal, m[1][0] - m[0][1]);
+  }
+
+  const float diagonal = 1.0f + m[0][0] + m[1][1] + m[2][2];
+  row = Float4Set(diagonal, m[2][1] - m[1][2], m[0][2] - m[2][0], m[1][0] - m[0][1]);
+  return diagonal;
+}
+
+// the rotation of a pose matrix
+inline Quatf GetRotation(const vr::HmdMatrix34_t& matrix) {
+  Float4 row;
+  const float diagonal = GetRotationRow(matrix, row);
+
+  return {Float4Mul(row, Float4Splat(std::copysign(0.5f, diagonal) / std::sqrt(std::abs(diagonal))))};
+}
+
+// the rotations of many poses, such as every device from GetRawTrackedDevicePoses, four at a time so that they share their square roots and
+// divides. Matches GetRotation exactly
+inline void GetRotations(const std::span<const vr::TrackedDevicePose_t> poses, const std::span<Quatf> rotations) {
+  const size_t count = std::min(poses.size(), rotations.size());
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    Float4 rows[4];
+    const float diagonals[4] = {
+        GetRotationRow(poses[i].mDeviceToAbsoluteTracking, rows[0]),
+        GetRotationRow(poses[i + 1].mDeviceToAbsoluteTracking, rows[1]),
+        GetRotationRow(poses[i + 2].mDeviceToAbsoluteTracking, rows[2]),
+        GetRotationRow(poses[i + 3].mDeviceToAbsoluteTracking, rows[3])};
+
+    const Float4 scales = Float4DivSqrt(
+        Float4Set(
+            std::copysign(0.5f, diagonals[0]),
+            std::copysign(0.5f, diagonals[1]),
+            std::copysign(0.5f, diagonals[2]),
+            std::copysign(0.5f, diagonals[3])),
+        Float4Set(std::abs(diagonals[0]), std::abs(diagonals[1]), std::abs(diagonals[2]), std::abs(diagonals[3])));
+
+    rotations[i] = {Float4Mul(rows[0], Float4Broadcast<0>(scales))};
+    rotations[i + 1] = {Float4Mul(rows[1], Float4Broadcast<1>(scales))};
+    rotations[i + 2] = {Float4Mul(rows[2], Float4Broadcast<2>(scales))};
+    rotations[i + 3] = {Float4Mul(rows[3], Float4Broadcast<3>(scales))};
+  }
+
+  for (; i < count; i++) rotations[i] = GetRotation(poses[i].mDeviceToAbsoluteTracking);
+}
+
+inline Vec3f GetPosition(const vr::HmdMatrix34_t& matrix) {
+  return {Float4Set(matrix.m[0][3], matrix.m[1][3], matrix.m[2][3], 0.0f)};
+}
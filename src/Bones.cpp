@@ -1,20 +1,51 @@
 #include "Bones.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <utility>
 
 #include "DriverLog.h"
 #include "Util/Quaternion.h"
+#include "Util/SimdMath.h"
 
-static const float c_maxSplayAngle = 20.0f;
+// splay is a rotation about the y axis of a single bone, so it's looked up from the cosine and sine of the half angle over the range of splay
+// (-1 -> 1) rather than built from euler angles every frame. Entries are close enough together that interpolating between them is accurate
+// to float precision, so analog values of any resolution can share the one table
+static const size_t c_splayTableSteps = 256;
 
-static const std::array<float, 4> emptyRotation = {0.0f, 0.0f, 0.0f, 0.0f};
-static const std::array<float, 3> emptyTranslation = {0.0f, 0.0f, 0.0f};
+struct SplayTableEntry {
+  float cos;
+  float sin;
+};
+
+static const std::array<SplayTableEntry, c_splayTableSteps + 1> splayTable = [] {
+  std::array<SplayTableEntry, c_splayTableSteps + 1> result{};
+  for (size_t i = 0; i <= c_splayTableSteps; i++) {
+    const double splay = static_cast<double>(i) / c_splayTableSteps * 2.0 - 1.0;
+    const double halfAngle = DegToRad(splay * c_maxSplayAngle) * 0.5;
+
+    result[i] = {static_cast<float>(std::cos(halfAngle)), static_cast<float>(std::sin(halfAngle))};
+  }
+
+  return result;
+}();
+
+vr::HmdQuaternionf_t BoneAnimator::GetSplayRotation(const float splay) {
+  const float position = (splay + 1.0f) * 0.5f * static_cast<float>(c_splayTableSteps);
+  const size_t lowerIndex = std::min(static_cast<size_t>(position), c_splayTableSteps - 1);
+  const float interp = position - static_cast<float>(lowerIndex);
 
-static float Lerp(const float& a, const float& b, const float& f) {
-  return a + f * (b - a);
+  const SplayTableEntry& lower = splayTable[lowerIndex];
+  const SplayTableEntry& upper = splayTable[lowerIndex + 1];
+
+  return {lower.cos + interp * (upper.cos - lower.cos), 0.0f, lower.sin + interp * (upper.sin - lower.sin), 0.0f};
 }
 
+// inputs are quantized to this many steps per unit before being compared to the last frame, so that changes finer than a 12 bit analog value
+// can represent don't count as movement
+static const float c_inputQuantizationSteps = 4096.0f;
+
 enum class FingerIndex : int { Thumb = 0, IndexFinger, MiddleFinger, RingFinger, PinkyFinger, Unknown = -1 };
 
 static bool IsBoneSplayableBone(const HandSkeletonBone& bone) {
@@ -78,114 +109,101 @@ static HandSkeletonBone GetRootFingerBoneFromFingerIndex(const FingerIndex& fing
   }
 }
 
-void BoneAnimator::TransformLeftBone(vr::VRBoneTransform_t& bone, const HandSkeletonBone& boneIndex) {
-  switch (boneIndex) {
-    case HandSkeletonBone::Root: {
-      return;
-    }
-    case HandSkeletonBone::Thumb0:
-    case HandSkeletonBone::IndexFinger0:
-    case HandSkeletonBone::MiddleFinger0:
-    case HandSkeletonBone::RingFinger0:
-    case HandSkeletonBone::PinkyFinger0: {
-      const vr::HmdQuaternionf_t quat = bone.orientation;
-      bone.orientation.w = -quat.x;
-      bone.orientation.x = quat.w;
-      bone.orientation.y = -quat.z;
-      bone.orientation.z = quat.y;
-      break;
-    }
-    case HandSkeletonBone::Wrist:
-    case HandSkeletonBone::AuxIndexFinger:
-    case HandSkeletonBone::AuxThumb:
-    case HandSkeletonBone::AuxMiddleFinger:
-    case HandSkeletonBone::AuxRingFinger:
-    case HandSkeletonBone::AuxPinkyFinger: {
-      bone.orientation.y *= -1;
-      bone.orientation.z *= -1;
-      break;
-    }
-    default: {
-      bone.position.v[1] *= -1;
-      bone.position.v[2] *= -1;
-    }
-  }
-
-  bone.position.v[0] *= -1;
-}
-
 static bool IsAuxBone(const HandSkeletonBone& boneIndex) {
   return boneIndex == HandSkeletonBone::AuxThumb || boneIndex == HandSkeletonBone::AuxIndexFinger || boneIndex == HandSkeletonBone::AuxMiddleFinger ||
          boneIndex == HandSkeletonBone::AuxRingFinger || boneIndex == HandSkeletonBone::AuxPinkyFinger;
 }
 
-BoneAnimator::BoneAnimator(const std::string& fileName) : fileName_(fileName) {
-  modelManager_ = std::make_unique<GLTFModelManager>(fileName);
+// every value outside of a valid curl or splay is treated the same, so they all quantize to the same value. Valid values are offset to be
+// positive first, so that truncating them rounds to the nearest step without a call into the math library
+static int32_t QuantizeInput(const float value) {
+  if (!(value >= -1.0f && value <= 1.0f)) return std::numeric_limits<int32_t>::min();
+
+  return static_cast<int32_t>(value * c_inputQuantizationSteps + (c_inputQuantizationSteps + 0.5f)) - static_cast<int32_t>(c_inputQuantizationSteps);
+}
+
+BoneAnimator::BoneAnimator(const std::string& fileName, const int bakeResolution) : fileName_(fileName) {
+  modelManager_ = std::make_unique<GLTFModelManager>(fileName, bakeResolution);
   loaded_ = modelManager_->Load();
 }
 
-void BoneAnimator::ComputeSkeletonTransforms(vr::VRBoneTransform_t* skeleton, const VRInputData& inputData, const bool rightHand) {
-  if (!loaded_) return;
+bool BoneAnimator::ComputeSkeletonTransforms(
+    vr::VRBoneTransform_t* skeleton, vr::VRBoneTransform_t* controllerSkeleton, const VRInputData& inputData, const bool rightHand) {
+  if (!loaded_) return false;
+
+  if (rightHand != lastRightHand_) lastFingerInputsValid_ = false;
+  lastRightHand_ = rightHand;
+
+  // fingers whose input hasn't changed since the last call keep the bones they already have in the skeleton
+  std::array<bool, 5> fingerChanged{};
+  bool anyFingerChanged = false;
+
+  for (size_t finger = 0; finger < fingerChanged.size(); finger++) {
+    FingerInput fingerInput;
+    for (size_t joint = 0; joint < inputData.flexion[finger].size(); joint++) fingerInput[joint] = QuantizeInput(inputData.flexion[finger][joint]);
+    fingerInput[inputData.flexion[finger].size()] = QuantizeInput(inputData.splay[finger]);
+
+    fingerChanged[finger] = !lastFingerInputsValid_ || fingerInput != lastFingerInputs_[finger];
+    anyFingerChanged = anyFingerChanged || fingerChanged[finger];
+
+    lastFingerInputs_[finger] = fingerInput;
+  }
+
+  lastFingerInputsValid_ = true;
+
+  if (!anyFingerChanged) return false;
+
+  // bones with a valid curl on the fingers that changed, and the keyframes each is between
+  std::array<size_t, NUM_BONES> bones;
+  size_t boneCount = 0;
+  std::array<KeyframeInterval, NUM_BONES> intervals;
+  std::array<bool, NUM_BONES> boneUpdated{};
+
+  // joints of a finger often share a curl value, only look up the keyframes when it changes
+  float lastCurl = -1.0f;
+  KeyframeInterval lastInterval{};
 
   for (size_t i = 1; i < NUM_BONES; i++) {
     const FingerIndex finger = GetFingerFromBoneIndex(static_cast<HandSkeletonBone>(i));
     const int iFinger = static_cast<int>(finger);
 
-    if (finger == FingerIndex::Unknown) continue;
+    if (finger == FingerIndex::Unknown || !fingerChanged[iFinger]) continue;
 
-    float curl;
-    if (IsAuxBone(static_cast<HandSkeletonBone>(i)))
-      curl = GetAverageCurlValue(inputData.flexion[iFinger]);
-    else
-      curl = inputData.flexion[iFinger][i - static_cast<int>(GetRootFingerBoneFromFingerIndex(finger))];
+    const float curl = IsAuxBone(static_cast<HandSkeletonBone>(i))
+                           ? GetAverageCurlValue(inputData.flexion[iFinger])
+                           : inputData.flexion[iFinger][i - static_cast<int>(GetRootFingerBoneFromFingerIndex(finger))];
 
-    const float splay = inputData.splay[iFinger];
+    // We don't clamp this, as chances are if it's invalid we don't really want to use it anyway.
+    if (curl < 0.0f || curl > 1.0f) continue;
 
-    SetTransformForBone(skeleton[i], static_cast<HandSkeletonBone>(i), curl, splay, rightHand);
-  }
-}
+    if (curl != lastCurl) {
+      lastCurl = curl;
+      lastInterval = modelManager_->GetKeyframeInterval(lastCurl);
+    }
 
-// splay asssumesthat there is a valid curl value for the finger
-void BoneAnimator::SetTransformForBone(
-    vr::VRBoneTransform_t& bone, const HandSkeletonBone& boneIndex, const float curl, const float splay, const bool rightHand) const {
-  // We don't clamp this, as chances are if it's invalid we don't really want to use it anyway.
-  if (curl < 0.0f || curl > 1.0f) return;
-
-  const Transform nodeTransform = modelManager_->GetTransformByBoneIndex(boneIndex);
-  bone.orientation.x = nodeTransform.rotation[0];
-  bone.orientation.y = nodeTransform.rotation[1];
-  bone.orientation.z = nodeTransform.rotation[2];
-  bone.orientation.w = nodeTransform.rotation[3];
-  bone.position.v[0] = nodeTransform.translation[0];
-  bone.position.v[1] = nodeTransform.translation[1];
-  bone.position.v[2] = nodeTransform.translation[2];
-
-  const AnimationData animationData = modelManager_->GetAnimationDataByBoneIndex(boneIndex, curl);
-
-  const float interp = std::clamp((curl - animationData.startTime) / (animationData.endTime - animationData.startTime), 0.0f, 1.0f);
-
-  if (animationData.startTransform.rotation != emptyRotation) {
-    bone.orientation.w = Lerp(animationData.startTransform.rotation[0], animationData.endTransform.rotation[0], interp);
-    bone.orientation.x = Lerp(animationData.startTransform.rotation[1], animationData.endTransform.rotation[1], interp);
-    bone.orientation.y = Lerp(animationData.startTransform.rotation[2], animationData.endTransform.rotation[2], interp);
-    bone.orientation.z = Lerp(animationData.startTransform.rotation[3], animationData.endTransform.rotation[3], interp);
+    intervals[i] = lastInterval;
+    bones[boneCount++] = i;
+    boneUpdated[i] = true;
   }
 
-  if (animationData.startTransform.translation != emptyTranslation) {
-    bone.position.v[0] = Lerp(animationData.startTransform.translation[0], animationData.endTransform.translation[0], interp);
-    bone.position.v[1] = Lerp(animationData.startTransform.translation[1], animationData.endTransform.translation[1], interp);
-    bone.position.v[2] = Lerp(animationData.startTransform.translation[2], animationData.endTransform.translation[2], interp);
-  }
-  bone.position.v[3] = 1.0f;
+  // both ranges share the intervals we just found, so the with-controller range is evaluated alongside the other, straight into the skeletons
+  modelManager_->GetTransforms({bones.data(), boneCount}, intervals.data(), rightHand, skeleton, controllerSkeleton);
+
+  // only splay one bone of each finger (all the rest are done relative to this one), in its own frame
+  for (size_t i = 1; i < NUM_BONES; i++) {
+    if (!boneUpdated[i] || !IsBoneSplayableBone(static_cast<HandSkeletonBone>(i))) continue;
+
+    const float splay = inputData.splay[static_cast<int>(GetFingerFromBoneIndex(static_cast<HandSkeletonBone>(i)))];
+    if (!(splay >= -1.0f && splay <= 1.0f)) continue;
 
-  if (splay >= -1.0f && splay <= 1.0f) {
-    // only splay one bone (all the rest are done relative to this one)
-    if (IsBoneSplayableBone(boneIndex)) bone.orientation = bone.orientation * EulerToQuaternion(0.0, DegToRad(splay * c_maxSplayAngle), 0.0);
+    const Quatf splayRotation = ToQuatf(GetSplayRotation(splay));
+    skeleton[i].orientation = ToHmdQuaternionf(ToQuatf(skeleton[i].orientation) * splayRotation);
+    if (controllerSkeleton != nullptr)
+      controllerSkeleton[i].orientation = ToHmdQuaternionf(ToQuatf(controllerSkeleton[i].orientation) * splayRotation);
   }
 
-  // we're guaranteed to have updated the bone, so we can safely apply a transformation
-  if (!rightHand) TransformLeftBone(bone, boneIndex);
-};
+  return true;
+}
 
 float BoneAnimator::GetAverageCurlValue(const std::array<float, 4>& joints) {
   float acc = 0;
@@ -197,8 +215,11 @@ float BoneAnimator::GetAverageCurlValue(const std::array<float, 4>& joints) {
 }
 
 void BoneAnimator::LoadDefaultSkeletonByHand(vr::VRBoneTransform_t* skeleton, const bool rightHand) {
+  // every bone is reset, so the next frame needs to compute all of them
+  lastFingerInputsValid_ = false;
+
   for (int i = 0; i < 31; i++) {
-    Transform transform = modelManager_->GetTransformByBoneIndex((HandSkeletonBone)i);
+    Transform transform = modelManager_->GetTransformByBoneIndex((HandSkeletonBone)i, rightHand);
     skeleton[i].orientation.w = transform.rotation[0];
     skeleton[i].orientation.x = transform.rotation[1];
     skeleton[i].orientation.y = transform.rotation[2];
@@ -208,7 +229,5 @@ void BoneAnimator::LoadDefaultSkeletonByHand(vr::VRBoneTransform_t* skeleton, co
     skeleton[i].position.v[1] = transform.translation[1];
     skeleton[i].position.v[2] = transform.translation[2];
     skeleton[i].position.v[3] = 1.0f;
-
-    if (!rightHand) TransformLeftBone(skeleton[i], (HandSkeletonBone)i);
   }
 }
\ No newline at end of file
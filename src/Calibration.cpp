@@ -1,6 +1,7 @@
 #include "Calibration.h"
 
 #include "Util/Quaternion.h"
+#include "Util/SimdMath.h"
 
 Calibration::Calibration() : maintainPose_(), isCalibrating_(false), calibratingMethod_(CalibrationMethod::None) {}
 
@@ -30,24 +31,20 @@ VRPoseConfiguration Calibration::CompleteCalibration(
   // maintainPose contains the position of the controller as DriverFromWorld<Rotation/Translation> and the offsets we apply as qRotation and
   // vecPosition
 
-  const vr::HmdVector3d_t newControllerPosition = GetPosition(controllerPose.mDeviceToAbsoluteTracking);
-  const vr::HmdQuaternion_t newControllerRotation = GetRotation(controllerPose.mDeviceToAbsoluteTracking);
+  const Vec3f newControllerPosition = GetPosition(controllerPose.mDeviceToAbsoluteTracking);
+  const Quatf newControllerRotation = GetRotation(controllerPose.mDeviceToAbsoluteTracking);
 
-  const vr::HmdQuaternion_t lastControllerRotation = maintainPose_.qWorldFromDriverRotation * poseConfiguration.angleOffsetQuaternion;
+  const Quatf lastWorldFromDriverRotation = ToQuatf(maintainPose_.qWorldFromDriverRotation);
+  const Quatf lastControllerRotation = lastWorldFromDriverRotation * ToQuatf(poseConfiguration.angleOffsetQuaternion);
 
-  const vr::HmdVector3d_t lastOffsetVecPosition = poseConfiguration.offsetVector * maintainPose_.qWorldFromDriverRotation;
-  const vr::HmdVector3d_t lastControllerPosition{
-      maintainPose_.vecWorldFromDriverTranslation[0] + lastOffsetVecPosition.v[0],
-      maintainPose_.vecWorldFromDriverTranslation[1] + lastOffsetVecPosition.v[1],
-      maintainPose_.vecWorldFromDriverTranslation[2] + lastOffsetVecPosition.v[2],
-  };
+  const Vec3f lastOffsetVecPosition = Rotate(lastWorldFromDriverRotation, ToVec3f(poseConfiguration.offsetVector));
+  const Vec3f lastControllerPosition = LoadVec3(maintainPose_.vecWorldFromDriverTranslation) + lastOffsetVecPosition;
 
-  const vr::HmdQuaternion_t transformQuat = -newControllerRotation * lastControllerRotation;
+  const vr::HmdQuaternion_t transformQuat = ToHmdQuaternion(Conjugate(newControllerRotation) * lastControllerRotation);
 
   poseConfiguration.angleOffsetQuaternion = transformQuat;
 
-  const vr::HmdVector3d_t differenceVector = lastControllerPosition - newControllerPosition;
-  const vr::HmdVector3d_t transformVector = differenceVector * -newControllerRotation;
+  const vr::HmdVector3d_t transformVector = ToHmdVector3d(InverseRotate(newControllerRotation, lastControllerPosition - newControllerPosition));
 
   poseConfiguration.offsetVector = transformVector;
 
@@ -55,6 +55,8 @@ bool BTSerialCommunicationManager::ReceiveNextPacket(std::string& buff) {
       return false;
     }
     if (receiveResult <= 0 || nextChar == '\n') continue;
+
+    if (buff.empty()) packetArrivalTime_ = std::chrono::steady_clock::now();
     buff += nextChar;
   } while (threadActive_ && (nextChar != '\n' || buff.length() < 1));
 
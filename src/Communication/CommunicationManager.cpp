@@ -14,7 +14,7 @@ CommunicationManager::CommunicationManager(VRCommunicationConfiguration configur
   QueueSend(VRFFBData(0, 0, 0, 0, 0));
 }
 
-void CommunicationManager::BeginListener(const std::function<void(VRInputData)>& callback) {
+void CommunicationManager::BeginListener(const InputCallback callback) {
   threadActive_ = true;
   thread_ = std::thread(&CommunicationManager::ListenerThread, this, callback);
 }
@@ -38,14 +38,18 @@ void CommunicationManager::QueueSend(const VROutput& data) {
   if (encodingManager_ != nullptr && configuration_.feedbackEnabled) writeString_ += encodingManager_->Encode(data);
 }
 
-void CommunicationManager::ListenerThread(const std::function<void(VRInputData)>& callback) {
+void CommunicationManager::ListenerThread(const InputCallback callback) {
   WaitAttemptConnection();
 
   while (threadActive_) {
+    packetArrivalTime_ = {};
+
     if (std::string receivedString; ReceiveNextPacket(receivedString)) {
       try {
-        const VRInputData commData = encodingManager_->Decode(receivedString);
-        callback(commData);
+        encodingManager_->Decode(receivedString, inputData_);
+        inputData_.timestamp = packetArrivalTime_ != std::chrono::steady_clock::time_point{} ? packetArrivalTime_ : std::chrono::steady_clock::now();
+
+        callback(inputData_);
 
         if (configuration_.feedbackEnabled) {
           std::lock_guard lock(writeMutex_);
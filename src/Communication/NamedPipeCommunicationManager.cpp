@@ -1,23 +1,145 @@
 #include "Communication/NamedPipeCommunicationManager.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <regex>
 #include <utility>
 
+static const std::chrono::milliseconds c_maxProducerTimestampAge(500);
+
+// Combine the latest input from every connected client. Curls take the most curled value, axes the most deflected value and buttons are
+// pressed if any client presses them.
+template <typename T>
+static void MergeInputData(const std::vector<const T*>& messages, VRInputData& result) {
+  result = *messages[0];
+
+  for (size_t i = 1; i < messages.size(); i++) {
+    const VRInputData data = *messages[i];
+
+    for (size_t finger = 0; finger < result.flexion.size(); finger++) {
+      for (size_t joint = 0; joint < result.flexion[finger].size(); joint++)
+        result.flexion[finger][joint] = std::max(result.flexion[finger][joint], data.flexion[finger][joint]);
+
+      // splay values outside of -1 -> 1 are invalid
+      const bool resultSplayValid = std::abs(result.splay[finger]) <= 1.0f;
+      const bool dataSplayValid = std::abs(data.splay[finger]) <= 1.0f;
+      if (dataSplayValid && (!resultSplayValid || std::abs(data.splay[finger]) > std::abs(result.splay[finger])))
+        result.splay[finger] = data.splay[finger];
+    }
+
+    if (std::abs(data.joyX) > std::abs(result.joyX)) result.joyX = data.joyX;
+    if (std::abs(data.joyY) > std::abs(result.joyY)) result.joyY = data.joyY;
+    result.trgValue = std::max(result.trgValue, data.trgValue);
+
+    result.joyButton |= data.joyButton;
+    result.trgButton |= data.trgButton;
+    result.aButton |= data.aButton;
+    result.bButton |= data.bButton;
+    result.grab |= data.grab;
+    result.pinch |= data.pinch;
+    result.menu |= data.menu;
+    result.calibrate |= data.calibrate;
+  }
+}
+
 NamedPipeCommunicationManager::NamedPipeCommunicationManager(const VRCommunicationConfiguration& configuration)
     : CommunicationManager(configuration), namedPipeConfiguration_(std::get<VRCommunicationNamedPipeConfiguration>(configuration.configuration)){};
 
 bool NamedPipeCommunicationManager::Connect() {
   namedPipeListeners_.emplace_back(std::make_unique<NamedPipeListener<VRInputDataVersion::v1>>(
       std::regex_replace(namedPipeConfiguration_.pipeName, std::regex("\\$version"), "v1"),
-      [&](VRInputDataVersion::v1* data) { callback_(static_cast<VRInputData>(*data)); }));
+      [&](VRInputDataVersion::v1* data) {
+        VRInputData& slot = inputSlots_[static_cast<int>(NamedPipeInputVersion::v1)];
+        slot = *data;
+        HandleInput(slot);
+      },
+      namedPipeConfiguration_.arbitration,
+      [&](const std::vector<const VRInputDataVersion::v1*>& data) {
+        VRInputData& slot = inputSlots_[static_cast<int>(NamedPipeInputVersion::v1)];
+        MergeInputData(data, slot);
+        HandleInput(slot);
+      }));
 
   namedPipeListeners_.emplace_back(std::make_unique<NamedPipeListener<VRInputDataVersion::v2>>(
       std::regex_replace(namedPipeConfiguration_.pipeName, std::regex("\\$version"), "v2"),
-      [&](VRInputDataVersion::v2* data) { callback_(static_cast<VRInputData>(*data)); }));
+      [&](VRInputDataVersion::v2* data) {
+        VRInputData& slot = inputSlots_[static_cast<int>(NamedPipeInputVersion::v2)];
+        static_cast<VRInputDataVersion::v2&>(slot) = *data;
+        HandleInput(slot);
+      },
+      namedPipeConfiguration_.arbitration,
+      [&](const std::vector<const VRInputDataVersion::v2*>& data) {
+        VRInputData& slot = inputSlots_[static_cast<int>(NamedPipeInputVersion::v2)];
+        MergeInputData(data, slot);
+        HandleInput(slot);
+      }));
+
+  namedPipeListeners_.emplace_back(std::make_unique<NamedPipeListener<VRInputDataVersion::v3>>(
+      std::regex_replace(namedPipeConfiguration_.pipeName, std::regex("\\$version"), "v3"),
+      [&](VRInputDataVersion::v3* data, const NamedPipeClient& client) { HandleBatch(*data, client); },
+      namedPipeConfiguration_.arbitration,
+      [&](const std::vector<const VRInputDataVersion::v3*>& data) {
+        VRInputData& slot = inputSlots_[static_cast<int>(NamedPipeInputVersion::v3)];
+        MergeInputData(data, slot);
+        HandleInput(slot);
+      }));
   return true;
 }
 
-void NamedPipeCommunicationManager::BeginListener(const std::function<void(VRInputData)>& callback) {
+void NamedPipeCommunicationManager::HandleInput(VRInputData& data) const {
+  // nothing sits between the pipe completing and us, so this is the earliest we know about the input
+  data.isLatestSample = true;
+  data.timestamp = std::chrono::steady_clock::now();
+
+  callback_(data);
+}
+
+void NamedPipeCommunicationManager::HandleBatch(const VRInputDataVersion::v3& data, const NamedPipeClient& client) {
+  const std::chrono::steady_clock::time_point arrivalTime = std::chrono::steady_clock::now();
+
+  // sequences are only comparable within one connection, as several clients can be writing to the pipe at once
+  BatchClient& batchClient = batchClients_[client.instance];
+  if (batchClient.connection != client.connection) batchClient = {client.connection};
+
+  const bool isNextBatch = batchClient.hasBatch && data.sequence == batchClient.lastSequence + 1;
+  if (batchClient.hasBatch && !isNextBatch)
+    DebugDriverLog("Named pipe batch sequence jumped from %u to %u on instance %zu", batchClient.lastSequence, data.sequence, client.instance);
+
+  // producers are on the same machine, so their timestamps can be used directly if they look sensible
+  const std::chrono::steady_clock::time_point producerTime(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::microseconds(data.timestamp)));
+  const bool producerTimeValid = data.timestamp != 0 && producerTime <= arrivalTime && arrivalTime - producerTime < c_maxProducerTimestampAge;
+  const std::chrono::steady_clock::time_point newestSampleTime = producerTimeValid ? producerTime : arrivalTime;
+
+  const uint32_t sampleCount = std::clamp<uint32_t>(data.sampleCount, 1, VRInputDataVersion::c_v3MaxSamples);
+
+  // the producer's spacing if it gives one, otherwise the time since the last batch shared out between the samples taken since
+  if (data.sampleInterval != 0) {
+    batchClient.sampleInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::microseconds(data.sampleInterval));
+  } else if (isNextBatch && newestSampleTime > batchClient.lastSampleTime) {
+    batchClient.sampleInterval = (newestSampleTime - batchClient.lastSampleTime) / sampleCount;
+  }
+
+  batchClient.hasBatch = true;
+  batchClient.lastSequence = data.sequence;
+  batchClient.lastSampleTime = newestSampleTime;
+
+  // older samples are spaced back from the newest, so consumers that track history (like the filter) see them at the rate they were taken.
+  // Until we know the spacing they can't be placed, and only the newest is delivered
+  const uint32_t firstSample = batchClient.sampleInterval > std::chrono::steady_clock::duration::zero() ? 0 : sampleCount - 1;
+
+  VRInputData& slot = inputSlots_[static_cast<int>(NamedPipeInputVersion::v3)];
+  for (uint32_t i = firstSample; i < sampleCount; i++) {
+    static_cast<VRInputDataVersion::v2&>(slot) = data.samples[i];
+    slot.isLatestSample = i == sampleCount - 1;
+    slot.timestamp = newestSampleTime - batchClient.sampleInterval * (sampleCount - 1 - i);
+
+    callback_(slot);
+  }
+}
+
+void NamedPipeCommunicationManager::BeginListener(const InputCallback callback) {
   callback_ = callback;
 
   if (!Connect()) {
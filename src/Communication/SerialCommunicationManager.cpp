@@ -131,6 +131,7 @@ bool SerialCommunicationManager::ReceiveNextPacket(std::string& buff) {
     }
     if (dwRead <= 0 || nextChar == '\n') continue;
 
+    if (buff.empty()) packetArrivalTime_ = std::chrono::steady_clock::now();
     buff += nextChar;
   } while ((nextChar != '\n' || buff.length() < 1) && threadActive_);
 
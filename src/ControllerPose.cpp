@@ -1,11 +1,17 @@
 #include "ControllerPose.h"
 
 #include "DriverLog.h"
-#include "Util/Quaternion.h"
 
 ControllerPose::ControllerPose(
     vr::ETrackedControllerRole shadowDeviceOfRole, std::string thisDeviceManufacturer, VRPoseConfiguration poseConfiguration)
-    : poseConfiguration_(poseConfiguration), shadowDeviceOfRole_(shadowDeviceOfRole), thisDeviceManufacturer_(std::move(thisDeviceManufacturer)) {
+    : poseConfiguration_(poseConfiguration),
+      poseComposer_(std::make_shared<const PoseComposer>(poseConfiguration)),
+      poseTimeOffset_(poseConfiguration.poseTimeOffset),
+      shadowDeviceOfRole_(shadowDeviceOfRole),
+      thisDeviceManufacturer_(std::move(thisDeviceManufacturer)),
+      poseSnapshot_(PoseSnapshot::Get()) {
+  poseSnapshot_->SetPredictionTime(poseTimeOffset_);
+
   calibrationPipe_ = std::make_unique<NamedPipeListener<CalibrationDataIn>>(
       R"(\\.\pipe\vrapplication\functions\autocalibrate\)" +
           std::string(shadowDeviceOfRole == vr::ETrackedControllerRole::TrackedControllerRole_RightHand ? "right" : "left"),
@@ -41,9 +47,12 @@ ControllerPose::~ControllerPose() {
 }
 
 vr::TrackedDevicePose_t ControllerPose::GetControllerPose() const {
-  vr::TrackedDevicePose_t trackedDevicePoses[vr::k_unMaxTrackedDeviceCount];
-  vr::VRServerDriverHost()->GetRawTrackedDevicePoses(0, trackedDevicePoses, vr::k_unMaxTrackedDeviceCount);
-  return trackedDevicePoses[shadowControllerId_];
+  return poseSnapshot_->GetPose(shadowControllerId_);
+}
+
+vr::TrackedDevicePose_t ControllerPose::GetControllerPose(
+    const std::chrono::steady_clock::duration maxAge, std::chrono::steady_clock::time_point* fetchTime) const {
+  return poseSnapshot_->GetPose(shadowControllerId_, maxAge, fetchTime);
 }
 
 vr::DriverPose_t ControllerPose::UpdatePose() const {
@@ -54,42 +63,12 @@ vr::DriverPose_t ControllerPose::UpdatePose() const {
   newPose.qWorldFromDriverRotation.w = 1;
 
   if (shadowControllerId_ != vr::k_unTrackedDeviceIndexInvalid) {
-    const vr::TrackedDevicePose_t controllerPose = GetControllerPose();
+    // the controller's pose is predicted to poseTimeOffset from when it was fetched, which may have been a little before now
+    std::chrono::steady_clock::time_point fetchTime;
+    const vr::TrackedDevicePose_t controllerPose = poseSnapshot_->GetPose(shadowControllerId_, &fetchTime);
     if (controllerPose.bPoseIsValid) {
-      const vr::HmdMatrix34_t controllerMatrix = controllerPose.mDeviceToAbsoluteTracking;
-
-      const vr::HmdQuaternion_t controllerRotation = GetRotation(controllerMatrix);
-      const vr::HmdVector3d_t controllerPosition = GetPosition(controllerMatrix);
-
-      newPose.qWorldFromDriverRotation = controllerRotation;
-
-      newPose.vecWorldFromDriverTranslation[0] = controllerPosition.v[0];
-      newPose.vecWorldFromDriverTranslation[1] = controllerPosition.v[1];
-      newPose.vecWorldFromDriverTranslation[2] = controllerPosition.v[2];
-
-      newPose.vecPosition[0] = poseConfiguration_.offsetVector.v[0];
-      newPose.vecPosition[1] = poseConfiguration_.offsetVector.v[1];
-      newPose.vecPosition[2] = poseConfiguration_.offsetVector.v[2];
-
-      const vr::HmdVector3_t objectVelocity = controllerPose.vVelocity * -controllerRotation;
-
-      newPose.vecVelocity[0] = objectVelocity.v[0];
-      newPose.vecVelocity[1] = objectVelocity.v[1];
-      newPose.vecVelocity[2] = objectVelocity.v[2];
-
-      const vr::HmdVector3_t objectAngularVelocity =
-          controllerPose.vAngularVelocity * -controllerRotation * -poseConfiguration_.angleOffsetQuaternion;
-
-      newPose.vecAngularVelocity[0] = objectAngularVelocity.v[0];
-      newPose.vecAngularVelocity[1] = objectAngularVelocity.v[1];
-      newPose.vecAngularVelocity[2] = objectAngularVelocity.v[2];
-
-      newPose.qRotation = poseConfiguration_.angleOffsetQuaternion;
-
-      newPose.poseIsValid = true;
-      newPose.deviceIsConnected = true;
-
-      newPose.result = vr::TrackingResult_Running_OK;
+      const std::chrono::duration<float> poseAge = std::chrono::steady_clock::now() - fetchTime;
+      newPose = poseComposer_.load()->Compose(controllerPose, poseTimeOffset_ - poseAge.count());
     } else {
       newPose.poseIsValid = false;
       newPose.deviceIsConnected = true;
@@ -113,7 +92,10 @@ void ControllerPose::CompleteCalibration(const CalibrationMethod method) {
     CancelCalibration(method);
     return;
   }
+
+  std::lock_guard<std::mutex> lock(calibrationMutex_);
   poseConfiguration_ = calibration_->CompleteCalibration(GetControllerPose(), poseConfiguration_, IsRightHand(), method);
+  poseComposer_.store(std::make_shared<const PoseComposer>(poseConfiguration_));
 }
 
 void ControllerPose::CancelCalibration(const CalibrationMethod method) const {
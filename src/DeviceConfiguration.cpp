@@ -4,9 +4,12 @@
 #include "Util/Quaternion.h"
 
 const char* c_poseSettingsSection = "pose_settings";
+const char* c_skeletonSettingsSection = "skeleton_settings";
+const char* c_filterSettingsSection = "filter_settings";
 const char* c_driverSettingsSection = "driver_openglove";
 const char* c_serialCommunicationSettingsSection = "communication_serial";
 const char* c_btserialCommunicationSettingsSection = "communication_btserial";
+const char* c_namedPipeCommunicationSettingsSection = "communication_namedpipe";
 const char* c_knuckleDeviceSettingsSection = "device_knuckles";
 const char* c_lucidGloveDeviceSettingsSection = "device_lucidgloves";
 const char* c_alphaEncodingSettingsSection = "encoding_alpha";
@@ -42,8 +45,11 @@ static VRCommunicationConfiguration GetCommunicationConfiguration(const bool isR
   switch (static_cast<VRCommunicationProtocol>(vr::VRSettings()->GetInt32(c_driverSettingsSection, "communication_protocol"))) {
     case VRCommunicationProtocol::NamedPipe: {
       const std::string pipeName = R"(\\.\pipe\vrapplication\input\glove\$version\)" + std::string(isRightHand ? "right" : "left");
+      const auto arbitration =
+          static_cast<VRNamedPipeArbitration>(vr::VRSettings()->GetInt32(c_namedPipeCommunicationSettingsSection, "client_arbitration"));
 
-      return {VRCommunicationProtocol::NamedPipe, encodingConfiguration, feedbackEnabled, VRCommunicationNamedPipeConfiguration{pipeName}};
+      return {
+          VRCommunicationProtocol::NamedPipe, encodingConfiguration, feedbackEnabled, VRCommunicationNamedPipeConfiguration{pipeName, arbitration}};
     }
 
     case VRCommunicationProtocol::BtSerial: {
@@ -82,8 +88,43 @@ static VRPoseConfiguration GetPoseConfiguration(bool isRightHand) {
           ? vr::VRSettings()->GetInt32(c_poseSettingsSection, isRightHand ? "controller_override_right" : "controller_override_left")
           : -1;
   const bool calibrationButtonEnabled = vr::VRSettings()->GetBool(c_poseSettingsSection, "hardware_calibration_button_enabled");
+  const float publishRate = vr::VRSettings()->GetFloat(c_poseSettingsSection, "publish_rate");
+  const bool publishOnControllerUpdate = vr::VRSettings()->GetBool(c_poseSettingsSection, "publish_on_controller_update");
+
+  return {
+      offsetVector,
+      angleOffsetQuaternion,
+      poseTimeOffset,
+      controllerIdOverride,
+      controllerOverrideEnabled,
+      calibrationButtonEnabled,
+      publishRate,
+      publishOnControllerUpdate};
+}
+
+static VRSkeletonConfiguration GetSkeletonConfiguration() {
+  const int animationBakeResolution = vr::VRSettings()->GetInt32(c_skeletonSettingsSection, "animation_bake_resolution");
+  const int heartbeatInterval = vr::VRSettings()->GetInt32(c_skeletonSettingsSection, "heartbeat_interval_ms");
+  const float predictionLead = vr::VRSettings()->GetFloat(c_skeletonSettingsSection, "prediction_lead");
+  const float predictionAlpha = vr::VRSettings()->GetFloat(c_skeletonSettingsSection, "prediction_alpha");
+  const float predictionBeta = vr::VRSettings()->GetFloat(c_skeletonSettingsSection, "prediction_beta");
+  const float publishRate = vr::VRSettings()->GetFloat(c_skeletonSettingsSection, "publish_rate");
+  const bool publishAtDisplayRate = vr::VRSettings()->GetBool(c_skeletonSettingsSection, "publish_at_display_rate");
+
+  return {animationBakeResolution, heartbeatInterval, predictionLead, predictionAlpha, predictionBeta, publishRate, publishAtDisplayRate};
+}
 
-  return {offsetVector, angleOffsetQuaternion, poseTimeOffset, controllerIdOverride, controllerOverrideEnabled, calibrationButtonEnabled};
+static VRFilterConfiguration GetFilterConfiguration() {
+  const bool enabled = vr::VRSettings()->GetBool(c_filterSettingsSection, "enabled");
+  const float flexionMinCutoff = vr::VRSettings()->GetFloat(c_filterSettingsSection, "flexion_min_cutoff");
+  const float flexionBeta = vr::VRSettings()->GetFloat(c_filterSettingsSection, "flexion_beta");
+  const float splayMinCutoff = vr::VRSettings()->GetFloat(c_filterSettingsSection, "splay_min_cutoff");
+  const float splayBeta = vr::VRSettings()->GetFloat(c_filterSettingsSection, "splay_beta");
+  const float joystickMinCutoff = vr::VRSettings()->GetFloat(c_filterSettingsSection, "joystick_min_cutoff");
+  const float joystickBeta = vr::VRSettings()->GetFloat(c_filterSettingsSection, "joystick_beta");
+  const float derivativeCutoff = vr::VRSettings()->GetFloat(c_filterSettingsSection, "derivative_cutoff");
+
+  return {enabled, flexionMinCutoff, flexionBeta, splayMinCutoff, splayBeta, joystickMinCutoff, joystickBeta, derivativeCutoff};
 }
 
 static VRDeviceConfiguration GetDeviceConfiguration(const vr::ETrackedControllerRole& role) {
@@ -93,6 +134,8 @@ static VRDeviceConfiguration GetDeviceConfiguration(const vr::ETrackedController
 
   const VRPoseConfiguration poseConfiguration = GetPoseConfiguration(isRightHand);
   const VRCommunicationConfiguration communicationConfiguration = GetCommunicationConfiguration(isRightHand);
+  const VRSkeletonConfiguration skeletonConfiguration = GetSkeletonConfiguration();
+  const VRFilterConfiguration filterConfiguration = GetFilterConfiguration();
 
   switch (static_cast<VRDeviceType>(vr::VRSettings()->GetInt32(c_driverSettingsSection, "device_driver"))) {
     case VRDeviceType::LucidGloves: {
@@ -105,6 +148,8 @@ static VRDeviceConfiguration GetDeviceConfiguration(const vr::ETrackedController
           role,
           poseConfiguration,
           communicationConfiguration,
+          skeletonConfiguration,
+          filterConfiguration,
           VRDeviceLucidglovesConfiguration{serialNumber}};
     }
 
@@ -123,6 +168,8 @@ static VRDeviceConfiguration GetDeviceConfiguration(const vr::ETrackedController
           role,
           poseConfiguration,
           communicationConfiguration,
+          skeletonConfiguration,
+          filterConfiguration,
           VRDeviceKnucklesConfiguration{indexCurlAsTrigger, approximateThumb}};
     }
   }
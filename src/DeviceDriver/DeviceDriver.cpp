@@ -1,5 +1,7 @@
 #include "DeviceDriver/DeviceDriver.h"
 
+#include <algorithm>
+#include <chrono>
 #include <utility>
 
 #include "Communication/BTSerialCommunicationManager.h"
@@ -13,6 +15,7 @@ DeviceDriver::DeviceDriver(VRDeviceConfiguration configuration)
     : configuration_(std::move(configuration)),
       skeletalComponentHandle_(),
       handTransforms_(),
+      controllerHandTransforms_(),
       isRunning_(false),
       deviceId_(vr::k_unTrackedDeviceIndexInvalid) {}
 
@@ -81,15 +84,12 @@ bool DeviceDriver::IsActive() {
   return isRunning_;
 }
 
-void DeviceDriver::PoseUpdateThread() const {
-  while (isActive_) {
-    vr::DriverPose_t pose = controllerPose_->UpdatePose();
-    vr::VRServerDriverHost()->TrackedDevicePoseUpdated(deviceId_, pose, sizeof(vr::DriverPose_t));
+double DeviceDriver::GetInputTimeOffset(const VRInputData& data) {
+  if (data.timestamp == std::chrono::steady_clock::time_point{}) return 0.0;
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(2));
-  }
+  const std::chrono::duration<double> age = std::chrono::steady_clock::now() - data.timestamp;
 
-  DriverLog("Closing pose thread...");
+  return -std::max(age.count(), 0.0);
 }
 
 bool DeviceDriver::IsRightHand() const {
@@ -104,7 +104,8 @@ void DeviceDriver::StartDevice() {
   SetupDeviceComponents();
 
   vr::VRDriverInput()->UpdateSkeletonComponent(skeletalComponentHandle_, vr::VRSkeletalMotionRange_WithoutController, handTransforms_, NUM_BONES);
-  vr::VRDriverInput()->UpdateSkeletonComponent(skeletalComponentHandle_, vr::VRSkeletalMotionRange_WithController, handTransforms_, NUM_BONES);
+  vr::VRDriverInput()->UpdateSkeletonComponent(
+      skeletalComponentHandle_, vr::VRSkeletalMotionRange_WithController, controllerHandTransforms_, NUM_BONES);
 }
 
 void DeviceDriver::OnEvent(vr::VREvent_t vrEvent) const {
@@ -170,10 +171,24 @@ void DeviceDriver::SetupDeviceComponents() {
     }
   }
 
+  const VRSkeletonConfiguration& skeletonConfiguration = configuration_.skeletonConfiguration;
+  const bool publishAtFixedRate = skeletonConfiguration.publishRate > 0.0f || skeletonConfiguration.publishAtDisplayRate;
+
+  // the publisher does its own prediction, as it predicts to when it publishes rather than when input arrives
+  inputFilter_ = configuration_.filterConfiguration.enabled ? std::make_unique<InputFilter>(configuration_.filterConfiguration) : nullptr;
+  inputPredictor_ =
+      skeletonConfiguration.predictionLead > 0.0f && !publishAtFixedRate ? std::make_unique<InputPredictor>(skeletonConfiguration) : nullptr;
+  skeletonPublisher_ =
+      publishAtFixedRate
+          ? std::make_unique<SkeletonPublisher>(skeletonConfiguration, SkeletonCallback::FromMethod<DeviceDriver, &DeviceDriver::PublishSkeleton>(this))
+          : nullptr;
+
   controllerPose_ = std::make_unique<ControllerPose>(configuration_.role, std::string(c_deviceManufacturer), configuration_.poseConfiguration);
 
-  boneAnimator_ = std::make_unique<BoneAnimator>(GetDriverPath() + R"(\resources\anims\glove_anim.glb)");
-  boneAnimator_->LoadDefaultSkeletonByHand(handTransforms_, configuration_.role == vr::ETrackedControllerRole::TrackedControllerRole_RightHand);
+  boneAnimator_ = std::make_unique<BoneAnimator>(
+      GetDriverPath() + R"(\resources\anims\glove_anim.glb)", configuration_.skeletonConfiguration.animationBakeResolution);
+  boneAnimator_->LoadDefaultSkeletonByHand(handTransforms_, IsRightHand());
+  boneAnimator_->LoadDefaultSkeletonByHand(controllerHandTransforms_, IsRightHand());
 
   ffbProvider_ = std::make_unique<FFBListener>(
       [&](const VRFFBData data) {
@@ -184,28 +199,86 @@ void DeviceDriver::SetupDeviceComponents() {
 
   ffbProvider_->Start();
 
-  communicationManager_->BeginListener([&](VRInputData data) {
-    try {
-      boneAnimator_->ComputeSkeletonTransforms(handTransforms_, data, IsRightHand());
-      vr::VRDriverInput()->UpdateSkeletonComponent(skeletalComponentHandle_, vr::VRSkeletalMotionRange_WithoutController, handTransforms_, NUM_BONES);
-      vr::VRDriverInput()->UpdateSkeletonComponent(skeletalComponentHandle_, vr::VRSkeletalMotionRange_WithController, handTransforms_, NUM_BONES);
+  if (skeletonPublisher_ != nullptr) skeletonPublisher_->Start();
+
+  communicationManager_->BeginListener(InputCallback::FromMethod<DeviceDriver, &DeviceDriver::OnInput>(this));
+
+  posePublisher_ = std::make_unique<PosePublisher>(
+      configuration_.poseConfiguration,
+      ControllerPoseSource::FromMethod<DeviceDriver, &DeviceDriver::GetControllerPose>(this),
+      PoseCallback::FromMethod<DeviceDriver, &DeviceDriver::PublishPose>(this));
+  posePublisher_->Start();
+}
+
+void DeviceDriver::OnInput(const VRInputData& rawData) {
+  // the raw frame belongs to the communication manager, so it's only copied when the filter has to change it
+  if (inputFilter_ != nullptr) {
+    filteredData_ = rawData;
+    inputFilter_->Filter(filteredData_);
+  }
+  const VRInputData& data = inputFilter_ != nullptr ? filteredData_ : rawData;
+
+  if (inputPredictor_ != nullptr) inputPredictor_->Update(data);
 
-      HandleInput(data);
+  // the publisher interpolates between samples, so it's given all of them and publishes the skeleton from its own thread
+  if (skeletonPublisher_ != nullptr) skeletonPublisher_->Submit(data);
 
-      if (configuration_.poseConfiguration.calibrationButtonEnabled) {
-        if (data.calibrate) {
-          if (!controllerPose_->IsCalibrating()) controllerPose_->StartCalibration(CalibrationMethod::Hardware);
-        } else {
-          if (controllerPose_->IsCalibrating()) controllerPose_->CompleteCalibration(CalibrationMethod::Hardware);
-        }
+  // older samples of a batched message only matter to consumers that track history (like the filter), the newest sample drives the skeleton
+  // and inputs
+  if (!data.isLatestSample) return;
+
+  try {
+    if (skeletonPublisher_ == nullptr) {
+      // the skeleton is shown where the fingers are expected to be by the time it's seen, rather than where they were when measured
+      if (inputPredictor_ != nullptr) {
+        predictedData_ = data;
+        inputPredictor_->Predict(
+            predictedData_, std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                                  std::chrono::duration<float>(configuration_.skeletonConfiguration.predictionLead)));
       }
 
-    } catch (const std::exception&) {
-      DebugDriverLog("Exception caught while parsing comm data");
+      PublishSkeleton(inputPredictor_ != nullptr ? predictedData_ : data);
+    }
+
+    HandleInput(data);
+
+    if (configuration_.poseConfiguration.calibrationButtonEnabled) {
+      if (data.calibrate) {
+        if (!controllerPose_->IsCalibrating()) controllerPose_->StartCalibration(CalibrationMethod::Hardware);
+      } else {
+        if (controllerPose_->IsCalibrating()) controllerPose_->CompleteCalibration(CalibrationMethod::Hardware);
+      }
     }
-  });
 
-  poseUpdateThread_ = std::thread(&DeviceDriver::PoseUpdateThread, this);
+  } catch (const std::exception&) {
+    DebugDriverLog("Exception caught while parsing comm data");
+  }
+}
+
+vr::TrackedDevicePose_t DeviceDriver::GetControllerPose(
+    const std::chrono::steady_clock::duration maxAge, std::chrono::steady_clock::time_point* fetchTime) {
+  return controllerPose_->GetControllerPose(maxAge, fetchTime);
+}
+
+void DeviceDriver::PublishPose() {
+  const vr::DriverPose_t pose = controllerPose_->UpdatePose();
+  vr::VRServerDriverHost()->TrackedDevicePoseUpdated(deviceId_, pose, sizeof(vr::DriverPose_t));
+}
+
+void DeviceDriver::PublishSkeleton(const VRInputData& skeletonData) {
+  const auto now = std::chrono::steady_clock::now();
+
+  const bool skeletonChanged = boneAnimator_->ComputeSkeletonTransforms(handTransforms_, controllerHandTransforms_, skeletonData, IsRightHand());
+
+  // a hand at rest doesn't need sending again, other than every so often to keep the runtime's copy fresh
+  const auto heartbeatInterval = std::chrono::milliseconds(configuration_.skeletonConfiguration.heartbeatInterval);
+  if (skeletonChanged || now - lastSkeletonUpdateTime_ >= heartbeatInterval) {
+    vr::VRDriverInput()->UpdateSkeletonComponent(skeletalComponentHandle_, vr::VRSkeletalMotionRange_WithoutController, handTransforms_, NUM_BONES);
+    vr::VRDriverInput()->UpdateSkeletonComponent(
+        skeletalComponentHandle_, vr::VRSkeletalMotionRange_WithController, controllerHandTransforms_, NUM_BONES);
+
+    lastSkeletonUpdateTime_ = now;
+  }
 }
 
 void DeviceDriver::StopDeviceComponents() {
@@ -214,7 +287,9 @@ void DeviceDriver::StopDeviceComponents() {
 
     communicationManager_->Disconnect();
 
-    poseUpdateThread_.join();
+    if (skeletonPublisher_ != nullptr) skeletonPublisher_->Stop();
+
+    posePublisher_->Stop();
   }
 
   vr::DriverPose_t pose;
@@ -162,8 +162,13 @@ static std::map<VRCommDataAlphaEncodingKey, std::string> ParseInputToMap(const s
   return result;
 }
 
-VRInputData AlphaEncodingManager::Decode(const std::string& input) {
-  VRInputData result;
+void AlphaEncodingManager::Decode(const std::string& input, VRInputData& result) {
+  // values the packet can leave out, which are overwritten below where it has them. The rest are always written
+  result.splay.fill(0.0f);
+  result.joyX = 0.0f;
+  result.joyY = 0.0f;
+  result.trgValue = 0.0f;
+  result.isLatestSample = true;
 
   std::array<float, 5> flexion = {-1.0f, -1.0f, -1.0f, -1.0f, -1.0f};
   
@@ -222,8 +227,6 @@ VRInputData AlphaEncodingManager::Decode(const std::string& input) {
   result.pinch = inputMap.find(VRCommDataAlphaEncodingKey::GesPinch) != inputMap.end();
   result.menu = inputMap.find(VRCommDataAlphaEncodingKey::BtnMenu) != inputMap.end();
   result.calibrate = inputMap.find(VRCommDataAlphaEncodingKey::BtnCalib) != inputMap.end();
-
-  return result;
 }
 
 std::string AlphaEncodingManager::Encode(const VROutput& input) {
@@ -20,8 +20,13 @@ enum class VRCommDataLegacyEncodingPosition : int {
   Max
 };
 
-VRInputData LegacyEncodingManager::Decode(const std::string& input) {
-  VRInputData result;
+void LegacyEncodingManager::Decode(const std::string& input, VRInputData& result) {
+  // values this encoding doesn't carry. The rest are written below
+  result.splay.fill(0.0f);
+  result.menu = false;
+  result.calibrate = false;
+  result.trgValue = 0.0f;
+  result.isLatestSample = true;
 
   std::string buf;
   std::stringstream ss(input);
@@ -49,8 +54,6 @@ VRInputData LegacyEncodingManager::Decode(const std::string& input) {
   result.bButton = tokens[static_cast<int>(VRCommDataLegacyEncodingPosition::BtnB)] == 1;
   result.grab = tokens[static_cast<int>(VRCommDataLegacyEncodingPosition::GesGrab)] == 1;
   result.pinch = tokens[static_cast<int>(VRCommDataLegacyEncodingPosition::GesPinch)] == 1;
-
-  return result;
 }
 
 std::string LegacyEncodingManager::Encode(const VROutput& input) {
@@ -0,0 +1,143 @@
+#include "InputFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Util/Simd.h"
+
+static const float c_pi = 3.14159265358979f;
+
+// offsets of each group of channels
+static const size_t c_flexionChannel = 0;
+static const size_t c_splayChannel = 20;
+static const size_t c_joystickChannel = 25;
+
+// a channel that has never been in range, so its first valid sample is taken as is
+static const float c_resetValue = -2.0f;
+
+// seconds between samples we assume until we've seen two with different timestamps
+static const float c_defaultSampleInterval = 0.01f;
+
+// samples closer together than this (or out of order, such as from two clients writing to one pipe) can't be timed, and use the last interval
+// we could. The samples of a batch are spaced out by the pipe, so they're timed like any other
+static const float c_minSampleInterval = 1e-4f;
+
+InputFilter::InputFilter(const VRFilterConfiguration& configuration)
+    : derivativeCutoff_(configuration.derivativeCutoff), sampleInterval_(c_defaultSampleInterval), lastTimestamp_() {
+  std::fill(minCutoff_.begin(), minCutoff_.end(), configuration.flexionMinCutoff);
+  std::fill(beta_.begin(), beta_.end(), configuration.flexionBeta);
+
+  std::fill(minCutoff_.begin() + c_splayChannel, minCutoff_.begin() + c_joystickChannel, configuration.splayMinCutoff);
+  std::fill(beta_.begin() + c_splayChannel, beta_.begin() + c_joystickChannel, configuration.splayBeta);
+
+  std::fill(minCutoff_.begin() + c_joystickChannel, minCutoff_.end(), configuration.joystickMinCutoff);
+  std::fill(beta_.begin() + c_joystickChannel, beta_.end(), configuration.joystickBeta);
+
+  value_.fill(c_resetValue);
+  derivative_.fill(0.0f);
+}
+
+void InputFilter::Filter(VRInputData& data) {
+  const std::chrono::steady_clock::time_point timestamp =
+      data.timestamp != std::chrono::steady_clock::time_point{} ? data.timestamp : std::chrono::steady_clock::now();
+
+  if (lastTimestamp_ != std::chrono::steady_clock::time_point{}) {
+    const float interval = std::chrono::duration<float>(timestamp - lastTimestamp_).count();
+    if (interval >= c_minSampleInterval) sampleInterval_ = interval;
+  }
+  lastTimestamp_ = timestamp;
+
+  alignas(16) Lanes input{};
+  for (size_t finger = 0; finger < data.flexion.size(); finger++) {
+    for (size_t joint = 0; joint < data.flexion[finger].size(); joint++)
+      input[c_flexionChannel + finger * data.flexion[finger].size() + joint] = data.flexion[finger][joint];
+
+    input[c_splayChannel + finger] = data.splay[finger];
+  }
+  input[c_joystickChannel] = data.joyX;
+  input[c_joystickChannel + 1] = data.joyY;
+
+  // a low pass with cutoff fc has a smoothing factor of r / (1 + r), where r = 2 pi fc dt
+  const float cutoffScale = 2.0f * c_pi * sampleInterval_;
+  const float derivativeRate = derivativeCutoff_ * cutoffScale;
+  const float derivativeAlpha = derivativeRate / (1.0f + derivativeRate);
+  const float inverseInterval = 1.0f / sampleInterval_;
+
+#if defined(OPENGLOVE_SIMD_SSE)
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  const __m128 one = _mm_set1_ps(1.0f);
+
+  for (size_t i = 0; i < c_inputFilterLaneCount; i += 4) {
+    const __m128 value = _mm_load_ps(&input[i]);
+    const __m128 previous = _mm_load_ps(&value_[i]);
+    const __m128 previousDerivative = _mm_load_ps(&derivative_[i]);
+
+    const __m128 valid = _mm_and_ps(_mm_cmple_ps(_mm_andnot_ps(signMask, value), one), _mm_cmple_ps(_mm_andnot_ps(signMask, previous), one));
+
+    const __m128 delta = _mm_sub_ps(value, previous);
+    const __m128 derivative = _mm_add_ps(
+        previousDerivative, _mm_mul_ps(_mm_set1_ps(derivativeAlpha), _mm_sub_ps(_mm_mul_ps(delta, _mm_set1_ps(inverseInterval)), previousDerivative)));
+
+    const __m128 cutoff = _mm_add_ps(_mm_load_ps(&minCutoff_[i]), _mm_mul_ps(_mm_load_ps(&beta_[i]), _mm_andnot_ps(signMask, derivative)));
+    const __m128 rate = _mm_mul_ps(cutoff, _mm_set1_ps(cutoffScale));
+    const __m128 filtered = _mm_add_ps(previous, _mm_mul_ps(_mm_div_ps(rate, _mm_add_ps(one, rate)), delta));
+
+    const __m128 result = _mm_or_ps(_mm_and_ps(valid, filtered), _mm_andnot_ps(valid, value));
+    _mm_store_ps(&input[i], result);
+    _mm_store_ps(&value_[i], result);
+    _mm_store_ps(&derivative_[i], _mm_and_ps(valid, derivative));
+  }
+#elif defined(OPENGLOVE_SIMD_NEON)
+  const float32x4_t one = vdupq_n_f32(1.0f);
+
+  for (size_t i = 0; i < c_inputFilterLaneCount; i += 4) {
+    const float32x4_t value = vld1q_f32(&input[i]);
+    const float32x4_t previous = vld1q_f32(&value_[i]);
+    const float32x4_t previousDerivative = vld1q_f32(&derivative_[i]);
+
+    const uint32x4_t valid = vandq_u32(vcaleq_f32(value, one), vcaleq_f32(previous, one));
+
+    const float32x4_t delta = vsubq_f32(value, previous);
+    const float32x4_t derivative =
+        vmlaq_n_f32(previousDerivative, vsubq_f32(vmulq_n_f32(delta, inverseInterval), previousDerivative), derivativeAlpha);
+
+    const float32x4_t cutoff = vmlaq_f32(vld1q_f32(&minCutoff_[i]), vld1q_f32(&beta_[i]), vabsq_f32(derivative));
+    const float32x4_t rate = vmulq_n_f32(cutoff, cutoffScale);
+    const float32x4_t filtered = vmlaq_f32(previous, vdivq_f32(rate, vaddq_f32(one, rate)), delta);
+
+    const float32x4_t result = vbslq_f32(valid, filtered, value);
+    vst1q_f32(&input[i], result);
+    vst1q_f32(&value_[i], result);
+    vst1q_f32(&derivative_[i], vbslq_f32(valid, derivative, vdupq_n_f32(0.0f)));
+  }
+#else
+  for (size_t i = 0; i < c_inputFilterLaneCount; i++) {
+    const float value = input[i];
+    const float previous = value_[i];
+
+    if (!(std::abs(value) <= 1.0f && std::abs(previous) <= 1.0f)) {
+      value_[i] = value;
+      derivative_[i] = 0.0f;
+      continue;
+    }
+
+    const float delta = value - previous;
+    const float derivative = derivative_[i] + derivativeAlpha * (delta * inverseInterval - derivative_[i]);
+
+    const float rate = (minCutoff_[i] + beta_[i] * std::abs(derivative)) * cutoffScale;
+
+    input[i] = previous + rate / (1.0f + rate) * delta;
+    value_[i] = input[i];
+    derivative_[i] = derivative;
+  }
+#endif
+
+  for (size_t finger = 0; finger < data.flexion.size(); finger++) {
+    for (size_t joint = 0; joint < data.flexion[finger].size(); joint++)
+      data.flexion[finger][joint] = input[c_flexionChannel + finger * data.flexion[finger].size() + joint];
+
+    data.splay[finger] = input[c_splayChannel + finger];
+  }
+  data.joyX = input[c_joystickChannel];
+  data.joyY = input[c_joystickChannel + 1];
+}
@@ -0,0 +1,82 @@
+#include "InputPredictor.h"
+
+#include <algorithm>
+
+// offset of the splay channels, which come after the flexion of every joint
+static const size_t c_splayChannel = 20;
+
+// seconds between samples we assume until we've seen two with different timestamps
+static const float c_defaultSampleInterval = 0.01f;
+
+// samples closer together than this (or out of order, such as from two clients writing to one pipe) can't be timed, and use the last interval
+// we could. The samples of a batch are spaced out by the pipe, so they're timed like any other
+static const float c_minSampleInterval = 1e-4f;
+
+// furthest we extrapolate past the newest sample, so that fingers don't carry on moving if the glove stops sending
+static const float c_maxPredictionHorizon = 0.1f;
+
+static void GetChannels(const VRInputData& data, std::array<float, c_inputPredictorChannelCount>& channels) {
+  for (size_t finger = 0; finger < data.flexion.size(); finger++) {
+    for (size_t joint = 0; joint < data.flexion[finger].size(); joint++) channels[finger * data.flexion[finger].size() + joint] = data.flexion[finger][joint];
+
+    channels[c_splayChannel + finger] = data.splay[finger];
+  }
+}
+
+static float GetChannelMin(const size_t channel) {
+  return channel < c_splayChannel ? 0.0f : -1.0f;
+}
+
+InputPredictor::InputPredictor(const VRSkeletonConfiguration& configuration)
+    : position_(), velocity_(), tracking_(), alpha_(configuration.predictionAlpha), beta_(configuration.predictionBeta),
+      sampleInterval_(c_defaultSampleInterval), lastTimestamp_() {}
+
+void InputPredictor::Update(const VRInputData& data) {
+  const std::chrono::steady_clock::time_point timestamp =
+      data.timestamp != std::chrono::steady_clock::time_point{} ? data.timestamp : std::chrono::steady_clock::now();
+
+  if (lastTimestamp_ != std::chrono::steady_clock::time_point{}) {
+    const float interval = std::chrono::duration<float>(timestamp - lastTimestamp_).count();
+    if (interval >= c_minSampleInterval) sampleInterval_ = interval;
+  }
+  lastTimestamp_ = timestamp;
+
+  Channels measured;
+  GetChannels(data, measured);
+
+  for (size_t i = 0; i < c_inputPredictorChannelCount; i++) {
+    if (!(measured[i] >= GetChannelMin(i) && measured[i] <= 1.0f)) {
+      tracking_[i] = false;
+      continue;
+    }
+
+    if (!tracking_[i]) {
+      position_[i] = measured[i];
+      velocity_[i] = 0.0f;
+      tracking_[i] = true;
+      continue;
+    }
+
+    const float expected = position_[i] + velocity_[i] * sampleInterval_;
+    const float residual = measured[i] - expected;
+
+    position_[i] = expected + alpha_ * residual;
+    velocity_[i] += beta_ / sampleInterval_ * residual;
+  }
+}
+
+void InputPredictor::Predict(VRInputData& data, const std::chrono::steady_clock::time_point targetTime) const {
+  const float horizon = std::clamp(std::chrono::duration<float>(targetTime - lastTimestamp_).count(), 0.0f, c_maxPredictionHorizon);
+
+  Channels predicted;
+  for (size_t i = 0; i < c_inputPredictorChannelCount; i++) predicted[i] = std::clamp(position_[i] + velocity_[i] * horizon, GetChannelMin(i), 1.0f);
+
+  for (size_t finger = 0; finger < data.flexion.size(); finger++) {
+    for (size_t joint = 0; joint < data.flexion[finger].size(); joint++) {
+      const size_t channel = finger * data.flexion[finger].size() + joint;
+      if (tracking_[channel]) data.flexion[finger][joint] = predicted[channel];
+    }
+
+    if (tracking_[c_splayChannel + finger]) data.splay[finger] = predicted[c_splayChannel + finger];
+  }
+}
@@ -0,0 +1,39 @@
+#include "PoseComposer.h"
+
+PoseComposer::PoseComposer(const VRPoseConfiguration& configuration)
+    : offsetPosition_(configuration.offsetVector),
+      offsetRotation_(configuration.angleOffsetQuaternion),
+      offsetRotationMatrix_(ToMat3x4f(Normalize(ToQuatf(configuration.angleOffsetQuaternion)), Vec3f{Float4Splat(0.0f)})) {}
+
+vr::DriverPose_t PoseComposer::Compose(const vr::TrackedDevicePose_t& controllerPose, const float poseTimeOffset) const {
+  const vr::HmdMatrix34_t& controllerMatrix = controllerPose.mDeviceToAbsoluteTracking;
+
+  vr::DriverPose_t result = {0};
+  result.qDriverFromHeadRotation.w = 1;
+
+  // the controller's pose becomes the driver's space, with the offset applied within it
+  result.qWorldFromDriverRotation = ToHmdQuaternion(GetRotation(controllerMatrix));
+  StoreVec3(GetPosition(controllerMatrix), result.vecWorldFromDriverTranslation);
+
+  result.qRotation = offsetRotation_;
+  std::copy_n(offsetPosition_.v, 3, result.vecPosition);
+
+  // velocities are reported in world space, and the pose takes them in the driver space. The rotation of the controller's matrix is world
+  // from driver, so its transpose takes them back
+  const Mat3x4f controllerRotation = ToMat3x4f(controllerMatrix);
+  const Vec3f angularVelocity = InverseTransformDirection(controllerRotation, ToVec3f(controllerPose.vAngularVelocity));
+
+  // the glove sits at the end of the offset, so it also moves as the controller turns
+  StoreVec3(
+      InverseTransformDirection(controllerRotation, ToVec3f(controllerPose.vVelocity)) + Cross(angularVelocity, ToVec3f(offsetPosition_)),
+      result.vecVelocity);
+  StoreVec3(InverseTransformDirection(offsetRotationMatrix_, angularVelocity), result.vecAngularVelocity);
+
+  result.poseTimeOffset = poseTimeOffset;
+
+  result.poseIsValid = true;
+  result.deviceIsConnected = true;
+  result.result = vr::TrackingResult_Running_OK;
+
+  return result;
+}
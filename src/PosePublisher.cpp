@@ -0,0 +1,409 @@
+#include "PosePublisher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "DriverLog.h"
+
+// rate we publish at if none is set, which is what the pose has always been published at
+static const float c_defaultPublishRate = 500.0f;
+
+// time between polls of the controller's pose while waiting for it to update
+static const std::chrono::microseconds c_pollInterval(100);
+
+// how long after an update is expected we wake to publish it, and how far before one we start looking for it when measuring its timing
+static const std::chrono::microseconds c_updateLag(100);
+static const std::chrono::microseconds c_measureLead(500);
+
+// updates between looks at when exactly the controller updates. Those in between aren't timed even when they arrive late, as only the late
+// ones could be, which would drag the timer later than the updates really are
+static const int c_updatesPerMeasurement = 16;
+
+// updates in a row we can miss (or see too early to time) before we stop following the controller and go back to a fixed rate
+static const int c_maxMissedUpdates = 8;
+
+// slowest update rate we follow, updates to time to learn the rate, and how long to wait before trying again if we couldn't
+static const std::chrono::steady_clock::duration c_maxUpdatePeriod = std::chrono::milliseconds(20);
+static const int c_searchUpdates = 9;
+static const std::chrono::seconds c_searchRetryInterval(1);
+
+// how far (in metres) a controller's position can stray from being carried on at its velocities between fetches of the same update, and
+// how much that grows with its speed, as the time the runtime predicts from is a little after we note the fetch
+static const float c_samePositionTolerance = 5e-6f;
+static const float c_fetchTimeUncertainty = 100e-6f;
+
+// how often publish telemetry is logged
+static const std::chrono::seconds c_telemetryInterval(30);
+
+PosePublisher::PosePublisher(const VRPoseConfiguration& configuration, const ControllerPoseSource controllerPoseSource, const PoseCallback callback)
+    : publishOnControllerUpdate_(configuration.publishOnControllerUpdate),
+      publishInterval_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<float>(1.0f / (configuration.publishRate > 0.0f ? configuration.publishRate : c_defaultPublishRate)))),
+      controllerPoseSource_(controllerPoseSource),
+      callback_(callback),
+      syncState_(SyncState::FixedRate),
+      controllerPose_(),
+      poseChangeWindow_(0),
+      searchUpdates_(0),
+      updatePeriod_(0),
+      updatesSinceObservation_(0),
+      missedUpdates_(0),
+      lastUpdateMissed_(false),
+      measureNext_(false),
+      isMeasuring_(false),
+      isWaitingForUpdate_(false),
+      publishCount_(0),
+      wakeupCount_(0),
+      wakeLatenessSum_(0.0),
+      maxWakeLateness_(0.0),
+      poseAgeSum_(0.0),
+      maxPoseAge_(0.0),
+      isRunning_(false) {
+#if defined(_WIN32)
+  // a condition variable's timed wait rounds up to the next millisecond, which is ten polls. A high resolution timer wakes within a few
+  // tens of microseconds, but older versions of Windows don't have them
+  waitTimer_ = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+  if (waitTimer_ == nullptr) {
+    DriverLog("High resolution timers aren't available, the pose publish thread will wake at the system timer's resolution");
+    waitTimer_ = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+  }
+
+  stopEvent_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+#endif
+}
+
+PosePublisher::~PosePublisher() {
+  Stop();
+
+#if defined(_WIN32)
+  if (waitTimer_ != nullptr) CloseHandle(waitTimer_);
+  if (stopEvent_ != nullptr) CloseHandle(stopEvent_);
+#endif
+}
+
+void PosePublisher::Start() {
+  if (isRunning_.exchange(true)) return;
+
+#if defined(_WIN32)
+  ResetEvent(stopEvent_);
+#endif
+
+  publishThread_ = std::thread(&PosePublisher::PublishThread, this);
+}
+
+void PosePublisher::Stop() {
+#if defined(_WIN32)
+  if (!isRunning_.exchange(false)) return;
+
+  SetEvent(stopEvent_);
+#else
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isRunning_.exchange(false)) return;
+  }
+
+  stopCondition_.notify_all();
+#endif
+
+  publishThread_.join();
+}
+
+// the runtime predicts a pose from when it's fetched, so it moves on every fetch, but its velocities and tracking state only change when
+// the controller updates. A controller held still can update with exactly the same velocities though, so the position is also carried on
+// from the first fetch at those velocities, which should land where the second fetch has it unless the controller was measured again
+bool PosePublisher::IsSamePose(const vr::TrackedDevicePose_t& a, const vr::TrackedDevicePose_t& b, const float elapsed) {
+  if (std::memcmp(&a.vVelocity, &b.vVelocity, sizeof(a.vVelocity)) != 0 ||
+      std::memcmp(&a.vAngularVelocity, &b.vAngularVelocity, sizeof(a.vAngularVelocity)) != 0 || a.eTrackingResult != b.eTrackingResult ||
+      a.bPoseIsValid != b.bPoseIsValid || a.bDeviceIsConnected != b.bDeviceIsConnected)
+    return false;
+
+  const float* velocity = a.vVelocity.v;
+  const float speed = std::sqrt(velocity[0] * velocity[0] + velocity[1] * velocity[1] + velocity[2] * velocity[2]);
+  const float tolerance = c_samePositionTolerance + speed * c_fetchTimeUncertainty;
+
+  // a NaN position stays the same, rather than looking like an update on every poll
+  for (int axis = 0; axis < 3; axis++) {
+    const float drift = b.mDeviceToAbsoluteTracking.m[axis][3] - a.mDeviceToAbsoluteTracking.m[axis][3] - velocity[axis] * elapsed;
+    if (std::abs(drift) > tolerance) return false;
+  }
+
+  return true;
+}
+
+bool PosePublisher::WaitUntil(const std::chrono::steady_clock::time_point wakeTime) {
+#if defined(_WIN32)
+  const std::chrono::steady_clock::duration delay = wakeTime - std::chrono::steady_clock::now();
+  if (delay <= std::chrono::steady_clock::duration::zero()) return isRunning_;
+
+  // negative due times are relative, in 100ns ticks
+  LARGE_INTEGER dueTime;
+  dueTime.QuadPart = -std::chrono::ceil<std::chrono::duration<LONGLONG, std::ratio<1, 10000000>>>(delay).count();
+
+  if (waitTimer_ == nullptr || !SetWaitableTimer(waitTimer_, &dueTime, 0, nullptr, nullptr, FALSE)) {
+    WaitForSingleObject(stopEvent_, static_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(delay).count()));
+    return isRunning_;
+  }
+
+  const HANDLE handles[] = {stopEvent_, waitTimer_};
+  WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+  return isRunning_;
+#else
+  std::unique_lock<std::mutex> lock(mutex_);
+  return !stopCondition_.wait_until(lock, wakeTime, [&] { return !isRunning_; });
+#endif
+}
+
+bool PosePublisher::PollControllerPose(const std::chrono::steady_clock::time_point now, const std::chrono::steady_clock::duration maxAge) {
+  std::chrono::steady_clock::time_point fetchTime = now;
+  const vr::TrackedDevicePose_t pose = controllerPoseSource_(maxAge, &fetchTime);
+  const bool changed = !IsSamePose(pose, controllerPose_, std::chrono::duration<float>(fetchTime - controllerPoseFetchTime_).count());
+
+  // all we know is that it changed some time between the fetches either side of the change, which may have been made for the other glove
+  if (changed) {
+    controllerPose_ = pose;
+    controllerPoseFetchTime_ = fetchTime;
+    poseChangeWindow_ =
+        lastPollTime_ != std::chrono::steady_clock::time_point{} ? fetchTime - lastPollTime_ : std::chrono::steady_clock::duration::zero();
+    poseChangeTime_ = fetchTime - poseChangeWindow_ / 2;
+  }
+  lastPollTime_ = fetchTime;
+
+  return changed;
+}
+
+void PosePublisher::ObserveUpdate(const std::chrono::steady_clock::time_point updateTime) {
+  const std::chrono::steady_clock::duration error = updateTime - expectedUpdate_;
+
+  // half of the error is taken out of the phase straight away, and a quarter of it, spread over the updates since the last one we timed,
+  // out of the period
+  expectedUpdate_ += error / 2;
+  updatePeriod_ = std::clamp(updatePeriod_ + error / (4 * std::max(updatesSinceObservation_, 1)), publishInterval_ * 3 / 4, c_maxUpdatePeriod);
+  updatesSinceObservation_ = 0;
+}
+
+std::chrono::steady_clock::time_point PosePublisher::ScheduleNextUpdate() {
+  // skip updates that went by while we were held up, rather than chasing them
+  expectedUpdate_ += updatePeriod_;
+  while (expectedUpdate_ < lastPollTime_) expectedUpdate_ += updatePeriod_;
+
+  updatesSinceObservation_++;
+  isMeasuring_ = updatesSinceObservation_ >= c_updatesPerMeasurement || measureNext_;
+  measureNext_ = false;
+  isWaitingForUpdate_ = false;
+
+  return isMeasuring_ ? expectedUpdate_ - c_measureLead : expectedUpdate_ + c_updateLag;
+}
+
+void PosePublisher::StartSearch(const std::chrono::steady_clock::time_point now) {
+  syncState_ = SyncState::Searching;
+  searchStart_ = now;
+  searchUpdates_ = 0;
+}
+
+void PosePublisher::UseFixedRate(const std::chrono::steady_clock::time_point now, const std::chrono::steady_clock::time_point nextSearch) {
+  syncState_ = SyncState::FixedRate;
+  nextSearch_ = nextSearch;
+  nextFixedPublish_ = std::max(now, lastPublishTime_ + publishInterval_);
+}
+
+std::chrono::steady_clock::time_point PosePublisher::OnFixedRateWake(const std::chrono::steady_clock::time_point now, const bool poseChanged) {
+  Publish(now);
+
+  // publishes are scheduled from when the last was due rather than when it happened, so that wake up delays don't add up
+  nextFixedPublish_ += publishInterval_;
+  if (nextFixedPublish_ < now) nextFixedPublish_ = now + publishInterval_;
+
+  // the controller just updated, so we can start timing its updates from here
+  if (poseChanged && now >= nextSearch_) {
+    StartSearch(now);
+    return now + c_pollInterval;
+  }
+
+  return nextFixedPublish_;
+}
+
+std::chrono::steady_clock::time_point PosePublisher::OnSearchWake(const std::chrono::steady_clock::time_point now, const bool poseChanged) {
+  if (poseChanged) {
+    Publish(now);
+
+    if (++searchUpdates_ == 1) {
+      firstSearchUpdate_ = poseChangeTime_;
+    } else if (searchUpdates_ == c_searchUpdates) {
+      const std::chrono::steady_clock::duration period = (poseChangeTime_ - firstSearchUpdate_) / (c_searchUpdates - 1);
+
+      // a controller updating faster than we publish gains nothing from being followed, as a fixed rate already publishes its poses
+      // younger than its update period
+      if (period < publishInterval_ * 3 / 4 || period > c_maxUpdatePeriod) {
+        UseFixedRate(now, now + c_searchRetryInterval);
+        return nextFixedPublish_;
+      }
+
+      DriverLog("Publishing the pose on the controller's updates, every %.3fms", std::chrono::duration<double, std::milli>(period).count());
+
+      syncState_ = SyncState::Locked;
+      updatePeriod_ = period;
+      expectedUpdate_ = poseChangeTime_;
+      updatesSinceObservation_ = 0;
+      missedUpdates_ = 0;
+      lastUpdateMissed_ = false;
+      measureNext_ = true;
+
+      return ScheduleNextUpdate();
+    }
+  } else if (now - lastPublishTime_ >= publishInterval_) {
+    Publish(now);
+  }
+
+  if (now - searchStart_ >= c_maxUpdatePeriod * (c_searchUpdates + 1)) {
+    UseFixedRate(now, now + c_searchRetryInterval);
+    return nextFixedPublish_;
+  }
+
+  return now + c_pollInterval;
+}
+
+std::chrono::steady_clock::time_point PosePublisher::OnLockedWake(const std::chrono::steady_clock::time_point now, const bool poseChanged) {
+  if (!isWaitingForUpdate_ && !poseChanged) {
+    isWaitingForUpdate_ = true;
+    return now + c_pollInterval;
+  }
+
+  if (!isWaitingForUpdate_ && isMeasuring_ && lastUpdateMissed_) {
+    // the update we gave up on came after all, so we keep looking for this one
+    lastUpdateMissed_ = false;
+    isWaitingForUpdate_ = true;
+
+    Publish(now);
+    return now + c_pollInterval;
+  }
+
+  if (!isWaitingForUpdate_) {
+    if (isMeasuring_ && now >= expectedUpdate_) {
+      // we woke too late to tell when it came
+      measureNext_ = true;
+    } else if (isMeasuring_) {
+      // it came before we started looking for it, so it's earlier than we thought by at least the lead. We keep timing updates until one
+      // comes while we're looking
+      ObserveUpdate(now);
+      missedUpdates_++;
+      measureNext_ = true;
+    } else {
+      poseChangeTime_ = std::min(expectedUpdate_, now);
+      missedUpdates_ = 0;
+    }
+
+    Publish(now);
+  } else if (poseChanged) {
+    // it's only timed if we were looking closely enough to tell when it came. If it came later than we woke for it, we time the next one
+    if (isMeasuring_ && poseChangeWindow_ <= 2 * c_pollInterval) {
+      ObserveUpdate(poseChangeTime_);
+    } else {
+      measureNext_ = true;
+    }
+    missedUpdates_ = 0;
+    lastUpdateMissed_ = false;
+
+    Publish(now);
+  } else if (now - expectedUpdate_ < updatePeriod_ / 2) {
+    return now + c_pollInterval;
+  } else {
+    // the controller may have stopped tracking, but the pose is still published at its rate for now
+    missedUpdates_++;
+    lastUpdateMissed_ = true;
+    measureNext_ = true;
+
+    Publish(now);
+  }
+
+  if (missedUpdates_ >= c_maxMissedUpdates) {
+    DriverLog("Lost track of the controller's updates, publishing the pose at %.1fHz", 1.0 / std::chrono::duration<double>(publishInterval_).count());
+
+    UseFixedRate(now, now);
+    return nextFixedPublish_;
+  }
+
+  return ScheduleNextUpdate();
+}
+
+void PosePublisher::Publish(const std::chrono::steady_clock::time_point now) {
+  callback_();
+  RecordPublish(now);
+}
+
+void PosePublisher::RecordPublish(const std::chrono::steady_clock::time_point now) {
+  if (lastPublishTime_ == std::chrono::steady_clock::time_point{}) lastTelemetryTime_ = now;
+  lastPublishTime_ = now;
+
+  const double poseAge = std::chrono::duration<double>(now - poseChangeTime_).count();
+  publishCount_++;
+  poseAgeSum_ += poseAge;
+  maxPoseAge_ = std::max(maxPoseAge_, poseAge);
+
+  if (now - lastTelemetryTime_ < c_telemetryInterval) return;
+
+  const double elapsed = std::chrono::duration<double>(now - lastTelemetryTime_).count();
+  if (syncState_ == SyncState::Locked) {
+    DriverLog(
+        "Pose published at %.1fHz following the controller's %.1fHz updates, %.1f wakeups/s (%.3fms late mean, %.3fms max), pose age %.3fms "
+        "mean, %.3fms max",
+        publishCount_ / elapsed,
+        1.0 / std::chrono::duration<double>(updatePeriod_).count(),
+        wakeupCount_ / elapsed,
+        wakeLatenessSum_ / std::max<uint64_t>(wakeupCount_, 1) * 1000.0,
+        maxWakeLateness_ * 1000.0,
+        poseAgeSum_ / publishCount_ * 1000.0,
+        maxPoseAge_ * 1000.0);
+  } else {
+    DriverLog(
+        "Pose published at %.1fHz at a fixed rate, %.1f wakeups/s (%.3fms late mean, %.3fms max), pose age %.3fms mean, %.3fms max",
+        publishCount_ / elapsed,
+        wakeupCount_ / elapsed,
+        wakeLatenessSum_ / std::max<uint64_t>(wakeupCount_, 1) * 1000.0,
+        maxWakeLateness_ * 1000.0,
+        poseAgeSum_ / publishCount_ * 1000.0,
+        maxPoseAge_ * 1000.0);
+  }
+
+  publishCount_ = 0;
+  wakeupCount_ = 0;
+  wakeLatenessSum_ = 0.0;
+  maxWakeLateness_ = 0.0;
+  poseAgeSum_ = 0.0;
+  maxPoseAge_ = 0.0;
+  lastTelemetryTime_ = now;
+}
+
+void PosePublisher::PublishThread() {
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  poseChangeTime_ = start;
+  UseFixedRate(start, publishOnControllerUpdate_ ? start : std::chrono::steady_clock::time_point::max());
+
+  std::chrono::steady_clock::time_point wakeTime = start;
+
+  while (WaitUntil(wakeTime)) {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const double wakeLateness = std::chrono::duration<double>(now - wakeTime).count();
+    wakeupCount_++;
+    wakeLatenessSum_ += wakeLateness;
+    maxWakeLateness_ = std::max(maxWakeLateness_, wakeLateness);
+
+    // at a fixed rate, a pose fetched for the other glove within half a publish ago is recent enough. Otherwise we're looking for the
+    // moment it changes, and one fetched within a poll ago is as recent as polling would get us, so the two gloves share their fetches
+    switch (syncState_) {
+      case SyncState::FixedRate:
+        wakeTime = OnFixedRateWake(now, PollControllerPose(now, publishInterval_ / 2));
+        break;
+
+      case SyncState::Searching:
+        wakeTime = OnSearchWake(now, PollControllerPose(now, c_pollInterval));
+        break;
+
+      case SyncState::Locked:
+        wakeTime = OnLockedWake(now, PollControllerPose(now, c_pollInterval));
+        break;
+    }
+  }
+
+  DriverLog("Closing pose publish thread...");
+}
@@ -0,0 +1,100 @@
+#include "PoseSnapshot.h"
+
+#include <cstring>
+#include <thread>
+
+// the gloves update their poses every 2ms. A snapshot younger than half of that was taken for this tick, so the other glove reads it
+// rather than fetching its own, and the next tick fetches again
+static const std::chrono::microseconds c_maxSnapshotAge(1000);
+
+static std::mutex snapshotMutex;
+static std::weak_ptr<PoseSnapshot> sharedSnapshot;
+
+std::shared_ptr<PoseSnapshot> PoseSnapshot::Get() {
+  std::lock_guard<std::mutex> lock(snapshotMutex);
+
+  std::shared_ptr<PoseSnapshot> result = sharedSnapshot.lock();
+  if (result == nullptr) {
+    result = std::make_shared<PoseSnapshot>();
+    sharedSnapshot = result;
+  }
+
+  return result;
+}
+
+PoseSnapshot::PoseSnapshot() : sequence_(0), poses_(), fetchTime_(0), predictionTime_(0.0f), fetchedPoses_() {}
+
+vr::TrackedDevicePose_t PoseSnapshot::GetPose(const uint32_t deviceIndex, std::chrono::steady_clock::time_point* fetchTime) {
+  return GetPose(deviceIndex, c_maxSnapshotAge, fetchTime);
+}
+
+vr::TrackedDevicePose_t PoseSnapshot::GetPose(
+    const uint32_t deviceIndex, const std::chrono::steady_clock::duration maxAge, std::chrono::steady_clock::time_point* fetchTime) {
+  if (deviceIndex >= vr::k_unMaxTrackedDeviceCount) return {};
+
+  if (GetAge() >= maxAge) Refresh(maxAge);
+
+  const PoseWords& words = poses_[deviceIndex];
+  uint32_t copy[c_poseWords];
+  std::chrono::steady_clock::rep copyFetchTime;
+
+  while (true) {
+    const uint32_t sequence = sequence_.load(std::memory_order_acquire);
+    if (sequence & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    for (size_t i = 0; i < c_poseWords; i++) copy[i] = words[i].load(std::memory_order_relaxed);
+    copyFetchTime = fetchTime_.load(std::memory_order_relaxed);
+
+    // the copy has to be finished before the sequence is checked again, or a write in between could go unnoticed
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == sequence) break;
+  }
+
+  vr::TrackedDevicePose_t result;
+  std::memcpy(&result, copy, sizeof(result));
+  if (fetchTime != nullptr) *fetchTime = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(copyFetchTime));
+
+  return result;
+}
+
+void PoseSnapshot::Refresh(const std::chrono::steady_clock::duration maxAge) {
+  std::lock_guard<std::mutex> lock(refreshMutex_);
+
+  // another glove may have fetched them while we waited
+  if (maxAge > std::chrono::steady_clock::duration::zero() && GetAge() < maxAge) return;
+
+  const std::chrono::steady_clock::time_point fetchTime = std::chrono::steady_clock::now();
+  vr::VRServerDriverHost()->GetRawTrackedDevicePoses(
+      predictionTime_.load(std::memory_order_relaxed), fetchedPoses_, vr::k_unMaxTrackedDeviceCount);
+  Publish(fetchTime);
+}
+
+void PoseSnapshot::SetPredictionTime(const float predictionTime) {
+  predictionTime_.store(predictionTime, std::memory_order_relaxed);
+}
+
+std::chrono::steady_clock::duration PoseSnapshot::GetAge() const {
+  return std::chrono::steady_clock::now().time_since_epoch() - std::chrono::steady_clock::duration(fetchTime_.load(std::memory_order_relaxed));
+}
+
+void PoseSnapshot::Publish(const std::chrono::steady_clock::time_point fetchTime) {
+  const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+  sequence_.store(sequence + 1, std::memory_order_relaxed);
+
+  // readers have to see the odd sequence before any of the poses change
+  std::atomic_thread_fence(std::memory_order_release);
+
+  for (size_t device = 0; device < vr::k_unMaxTrackedDeviceCount; device++) {
+    uint32_t words[c_poseWords];
+    std::memcpy(words, &fetchedPoses_[device], sizeof(words));
+
+    for (size_t i = 0; i < c_poseWords; i++) poses_[device][i].store(words[i], std::memory_order_relaxed);
+  }
+
+  fetchTime_.store(fetchTime.time_since_epoch().count(), std::memory_order_relaxed);
+
+  sequence_.store(sequence + 2, std::memory_order_release);
+}
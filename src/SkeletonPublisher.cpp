@@ -0,0 +1,185 @@
+#include "SkeletonPublisher.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "DriverLog.h"
+
+// refresh rate we assume if the headset doesn't report one and no fixed rate is set
+static const float c_defaultDisplayFrequency = 90.0f;
+
+// how often the headset's refresh rate is read again, as it can be changed while running
+static const std::chrono::seconds c_displayFrequencyQueryInterval(5);
+
+// how often publish interval telemetry is logged
+static const std::chrono::seconds c_telemetryInterval(30);
+
+// samples closer together than this (such as the samples of a batch, which arrive together) can't be timed, and replace the newest sample
+static const std::chrono::microseconds c_minSampleInterval(100);
+
+static float Lerp(const float from, const float to, const float t) {
+  // channels outside of -1 -> 1 aren't measured (such as splay from a glove that doesn't report it), so there's nothing to interpolate
+  if (!(std::abs(from) <= 1.0f && std::abs(to) <= 1.0f)) return to;
+
+  return from + (to - from) * t;
+}
+
+SkeletonPublisher::SkeletonPublisher(const VRSkeletonConfiguration& configuration, const SkeletonCallback callback)
+    : configuration_(configuration),
+      callback_(callback),
+      inputPredictor_(configuration.predictionLead > 0.0f ? std::make_unique<InputPredictor>(configuration) : nullptr),
+      hasSample_(false),
+      displayFrequency_(0.0f),
+      publishCount_(0),
+      intervalSum_(0.0),
+      intervalErrorSquareSum_(0.0),
+      maxIntervalError_(0.0),
+      targetIntervalSum_(0.0),
+      isRunning_(false) {}
+
+SkeletonPublisher::~SkeletonPublisher() {
+  Stop();
+}
+
+void SkeletonPublisher::Submit(const VRInputData& data) {
+  const std::chrono::steady_clock::time_point timestamp =
+      data.timestamp != std::chrono::steady_clock::time_point{} ? data.timestamp : std::chrono::steady_clock::now();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (inputPredictor_ != nullptr) inputPredictor_->Update(data);
+
+  if (!hasSample_) {
+    previousSample_ = data;
+    previousSampleTime_ = timestamp;
+    hasSample_ = true;
+  } else if (timestamp - latestSampleTime_ >= c_minSampleInterval) {
+    previousSample_ = latestSample_;
+    previousSampleTime_ = latestSampleTime_;
+  }
+
+  latestSample_ = data;
+  latestSampleTime_ = timestamp;
+}
+
+void SkeletonPublisher::Start() {
+  if (isRunning_.exchange(true)) return;
+
+  publishThread_ = std::thread(&SkeletonPublisher::PublishThread, this);
+}
+
+void SkeletonPublisher::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isRunning_.exchange(false)) return;
+  }
+
+  stopCondition_.notify_all();
+  publishThread_.join();
+}
+
+VRInputData SkeletonPublisher::GetSampleAt(const std::chrono::steady_clock::time_point time) const {
+  VRInputData result = latestSample_;
+
+  if (inputPredictor_ != nullptr) {
+    inputPredictor_->Predict(
+        result, time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(configuration_.predictionLead)));
+
+    return result;
+  }
+
+  const std::chrono::duration<float> sampleInterval = latestSampleTime_ - previousSampleTime_;
+  if (sampleInterval < c_minSampleInterval) return result;
+
+  // shown an input interval behind, which puts it between the newest two samples until the next one is due
+  const std::chrono::duration<float> sinceSample = std::chrono::duration<float>(time - previousSampleTime_) - sampleInterval;
+  const float t = std::clamp(sinceSample / sampleInterval, 0.0f, 1.0f);
+
+  for (size_t finger = 0; finger < result.flexion.size(); finger++) {
+    for (size_t joint = 0; joint < result.flexion[finger].size(); joint++)
+      result.flexion[finger][joint] = Lerp(previousSample_.flexion[finger][joint], latestSample_.flexion[finger][joint], t);
+
+    result.splay[finger] = Lerp(previousSample_.splay[finger], latestSample_.splay[finger], t);
+  }
+
+  return result;
+}
+
+std::chrono::steady_clock::duration SkeletonPublisher::GetPublishInterval(const std::chrono::steady_clock::time_point now) {
+  float frequency = configuration_.publishRate;
+
+  if (configuration_.publishAtDisplayRate) {
+    if (now - lastDisplayFrequencyQuery_ >= c_displayFrequencyQueryInterval) {
+      const vr::PropertyContainerHandle_t hmdProps = vr::VRProperties()->TrackedDeviceToPropertyContainer(vr::k_unTrackedDeviceIndex_Hmd);
+      displayFrequency_ = vr::VRProperties()->GetFloatProperty(hmdProps, vr::Prop_DisplayFrequency_Float);
+      lastDisplayFrequencyQuery_ = now;
+    }
+
+    if (displayFrequency_ > 0.0f) frequency = displayFrequency_;
+  }
+
+  if (frequency <= 0.0f) frequency = c_defaultDisplayFrequency;
+
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.0f / frequency));
+}
+
+void SkeletonPublisher::RecordPublish(const std::chrono::steady_clock::time_point time, const std::chrono::steady_clock::duration targetInterval) {
+  if (lastPublishTime_ != std::chrono::steady_clock::time_point{}) {
+    const double interval = std::chrono::duration<double>(time - lastPublishTime_).count();
+    const double target = std::chrono::duration<double>(targetInterval).count();
+    const double error = interval - target;
+
+    publishCount_++;
+    intervalSum_ += interval;
+    targetIntervalSum_ += target;
+    intervalErrorSquareSum_ += error * error;
+    maxIntervalError_ = std::max(maxIntervalError_, std::abs(error));
+  } else {
+    lastTelemetryTime_ = time;
+  }
+  lastPublishTime_ = time;
+
+  if (time - lastTelemetryTime_ < c_telemetryInterval || publishCount_ == 0) return;
+
+  DriverLog(
+      "Skeleton published at %.1fHz (target %.1fHz), interval jitter %.3fms rms, %.3fms max",
+      publishCount_ / intervalSum_,
+      publishCount_ / targetIntervalSum_,
+      std::sqrt(intervalErrorSquareSum_ / publishCount_) * 1000.0,
+      maxIntervalError_ * 1000.0);
+
+  publishCount_ = 0;
+  intervalSum_ = 0.0;
+  targetIntervalSum_ = 0.0;
+  intervalErrorSquareSum_ = 0.0;
+  maxIntervalError_ = 0.0;
+  lastTelemetryTime_ = time;
+}
+
+void SkeletonPublisher::PublishThread() {
+  std::chrono::steady_clock::time_point nextPublish = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration publishInterval = GetPublishInterval(nextPublish);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopCondition_.wait_until(lock, nextPublish, [&] { return !isRunning_; })) {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (hasSample_) {
+      const VRInputData sample = GetSampleAt(now);
+
+      // input keeps arriving while the skeleton is computed
+      lock.unlock();
+      callback_(sample);
+      RecordPublish(now, publishInterval);
+      lock.lock();
+    }
+
+    // publishes are scheduled from when the last was due rather than when it happened, so that wake up delays don't add up. If we've fallen
+    // more than a publish behind, skip the ones we missed rather than running them back to back
+    publishInterval = GetPublishInterval(now);
+    nextPublish += publishInterval;
+    if (nextPublish < now) nextPublish = now + publishInterval;
+  }
+
+  DriverLog("Closing skeleton publish thread...");
+}
@@ -1,6 +1,17 @@
 #include "Util/AnimLoader.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <ranges>
+#include <tuple>
+
 #include "DriverLog.h"
+#include "Util/AnimationBlob.h"
+#include "Util/SimdMath.h"
 
 #define TINYGLTF_IMPLEMENTATION
 #define TINYGLTF_NO_STB_IMAGE
@@ -14,8 +25,22 @@ static float Lerp(const float& a, const float& b, const float& f) {
 static const std::array<float, 4> emptyRotation = {0.0f, 0.0f, 0.0f, 0.0f};
 static const std::array<float, 3> emptyTranslation = {0.0f, 0.0f, 0.0f};
 
+// every bone of the animation, for evaluating all of them
+static const std::array<size_t, c_animationBoneCount> c_animationBones = [] {
+  std::array<size_t, c_animationBoneCount> result{};
+  for (size_t bone = 0; bone < c_animationBoneCount; bone++) result[bone] = bone;
+
+  return result;
+}();
+
+// fewer steps than this can't represent the animation, more is just wasted memory
+static const int c_minBakeResolution = 16;
+static const int c_maxBakeResolution = 4096;
+
+// times checked against the keyframed animation for each baked step
+static const int c_bakeErrorSamplesPerStep = 4;
+
 Transform::Transform() : rotation(emptyRotation), translation(emptyTranslation) {}
-AnimationData::AnimationData() : startTime(0.0f), endTime(0.0f) {}
 
 static const std::map<std::string, HandSkeletonBone> GLTFNodeBoneMap{
     {"REF:Root", HandSkeletonBone::Root},
@@ -87,6 +112,43 @@ static void MapRightTransform(Transform& transform, const HandSkeletonBone& bone
   }
 }
 
+// mirror a bone of the right hand into the same bone of the left hand, the rotation wxyz and the translation xyz
+static void MirrorRightTransform(float* rotation, float* translation, const HandSkeletonBone& boneIndex) {
+  switch (boneIndex) {
+    case HandSkeletonBone::Root: {
+      return;
+    }
+    case HandSkeletonBone::Thumb0:
+    case HandSkeletonBone::IndexFinger0:
+    case HandSkeletonBone::MiddleFinger0:
+    case HandSkeletonBone::RingFinger0:
+    case HandSkeletonBone::PinkyFinger0: {
+      const float quat[4] = {rotation[0], rotation[1], rotation[2], rotation[3]};
+      rotation[0] = -quat[1];
+      rotation[1] = quat[0];
+      rotation[2] = -quat[3];
+      rotation[3] = quat[2];
+      break;
+    }
+    case HandSkeletonBone::Wrist:
+    case HandSkeletonBone::AuxIndexFinger:
+    case HandSkeletonBone::AuxThumb:
+    case HandSkeletonBone::AuxMiddleFinger:
+    case HandSkeletonBone::AuxRingFinger:
+    case HandSkeletonBone::AuxPinkyFinger: {
+      rotation[2] *= -1;
+      rotation[3] *= -1;
+      break;
+    }
+    default: {
+      translation[1] *= -1;
+      translation[2] *= -1;
+    }
+  }
+
+  translation[0] *= -1;
+}
+
 // convert from xyzw (gltf format) to wxyz (openvr format)
 static void MapRotation(std::array<float, 4>& rotation) {
   float temp0 = rotation[0];
@@ -96,122 +158,1109 @@ static void MapRotation(std::array<float, 4>& rotation) {
   rotation[1] = temp0;
 }
 
-bool GLTFModelManager::Load() {
+// the vectors an animation is extracted or baked into, which the model created from them then points at
+struct AnimationModelBuffers {
+  std::vector<float> keyframeTimes;
+  std::vector<float> keyframeData;
+  std::vector<int16_t> quantizedRotations;
+  size_t rangeCount = 1;
+  size_t coefficientCount = 1;
+
+  // rotations are always extracted as floats, and only quantized once the animation is complete
+  float* GetKeyframeRotation(size_t set, size_t keyframe, size_t bone) {
+    return &keyframeData[AnimationModel::GetKeyframeRotationIndex(keyframeTimes.size(), coefficientCount, set, keyframe, bone)];
+  }
+  float* GetKeyframeTranslation(size_t set, size_t keyframe, size_t bone) {
+    return &keyframeData[AnimationModel::GetKeyframeTranslationIndex(
+        keyframeTimes.size(), coefficientCount, !quantizedRotations.empty(), set, keyframe, bone)];
+  }
+};
+
+// Fill in the left hand from the right hand. Mirroring only swaps and negates components, which interpolating and normalising between
+// keyframes treat the same either way round. The swizzle of the finger roots is a multiplication on the left by a constant, so it also
+// commutes with splay, which is applied on the right, and splay is never applied to the bones that are mirrored in any other way. So the
+// left hand animates exactly as the right hand mirrored afterwards would
+static void MirrorInitialTransforms(std::vector<Transform>& initialTransforms) {
+  for (size_t bone = 0; bone < c_animationBoneCount; bone++) {
+    Transform& transform = initialTransforms[AnimationModel::GetHandIndex(false) * c_animationBoneCount + bone];
+
+    transform = initialTransforms[AnimationModel::GetHandIndex(true) * c_animationBoneCount + bone];
+    MirrorRightTransform(transform.rotation.data(), transform.translation.data(), static_cast<HandSkeletonBone>(bone));
+  }
+}
+
+static void MirrorKeyframes(AnimationModelBuffers& buffers) {
+  for (size_t range = 0; range < buffers.rangeCount; range++) {
+    const size_t right = AnimationModel::GetKeyframeSet(static_cast<AnimationRange>(range), true);
+    const size_t left = AnimationModel::GetKeyframeSet(static_cast<AnimationRange>(range), false);
+
+    for (size_t keyframe = 0; keyframe < buffers.keyframeTimes.size(); keyframe++) {
+      for (size_t bone = 0; bone < c_animationBoneCount; bone++) {
+        float* rotation = buffers.GetKeyframeRotation(left, keyframe, bone);
+        float* translation = buffers.GetKeyframeTranslation(left, keyframe, bone);
+
+        std::copy_n(buffers.GetKeyframeRotation(right, keyframe, bone), c_keyframeRotationStride * buffers.coefficientCount, rotation);
+        std::copy_n(buffers.GetKeyframeTranslation(right, keyframe, bone), c_keyframeTranslationStride * buffers.coefficientCount, translation);
+
+        // mirroring only swaps and negates components, so each coefficient of a cubic mirrors the same as a value would
+        for (size_t c = 0; c < buffers.coefficientCount; c++) {
+          MirrorRightTransform(
+              rotation + c * c_keyframeRotationStride, translation + c * c_keyframeTranslationStride, static_cast<HandSkeletonBone>(bone));
+        }
+      }
+    }
+  }
+}
+
+static std::shared_ptr<AnimationModel> CreateAnimationModel(std::vector<Transform> initialTransforms, AnimationModelBuffers buffers, bool baked) {
+  const auto storage = std::make_shared<const AnimationModelBuffers>(std::move(buffers));
+
+  auto result = std::make_shared<AnimationModel>();
+  result->initialTransforms = std::move(initialTransforms);
+  result->keyframeTimes = storage->keyframeTimes;
+  result->keyframeData = storage->keyframeData;
+  result->quantizedRotations = storage->quantizedRotations;
+  result->rangeCount = storage->rangeCount;
+  result->coefficientCount = storage->coefficientCount;
+  result->baked = baked;
+  result->storage = storage;
+
+  return result;
+}
+
+static std::vector<float> CreateKeyframeData(const size_t keyframeCount, const size_t rangeCount, const size_t coefficientCount) {
+  std::vector<float> result(AnimationModel::GetKeyframeDataSize(keyframeCount, rangeCount, coefficientCount, false), 0.0f);
+
+  // identity rotations and the translation padding, so that bones that aren't in the model still interpolate to something valid. For a
+  // cubic, they go in the constant term
+  for (size_t set = 0; set < rangeCount * c_animationHandCount; set++) {
+    const size_t rotationOffset = AnimationModel::GetKeyframeRotationIndex(keyframeCount, coefficientCount, set, 0, 0);
+    const size_t translationOffset = AnimationModel::GetKeyframeTranslationIndex(keyframeCount, coefficientCount, false, set, 0, 0);
+    const size_t setEnd = rotationOffset + AnimationModel::GetKeyframeSetSize(keyframeCount, coefficientCount, false);
+
+    for (size_t i = rotationOffset; i < translationOffset; i += c_keyframeRotationStride * coefficientCount) result[i] = 1.0f;
+    for (size_t i = translationOffset; i < setEnd; i += c_keyframeTranslationStride * coefficientCount) result[i + 3] = 1.0f;
+  }
+
+  return result;
+}
+
+static int16_t QuantizeRotationComponent(const float component) {
+  return static_cast<int16_t>(std::lround(std::clamp(component, -1.0f, 1.0f) * c_rotationQuantizationScale));
+}
+
+// move the rotations of a linear animation out of keyframeData into 16 bit integers, leaving only the translations behind
+static void QuantizeKeyframeRotations(AnimationModelBuffers& buffers) {
+  const size_t keyframeCount = buffers.keyframeTimes.size();
+
+  std::vector<int16_t> rotations(AnimationModel::GetQuantizedRotationsSize(keyframeCount, buffers.rangeCount));
+  std::vector<float> translations(AnimationModel::GetKeyframeDataSize(keyframeCount, buffers.rangeCount, 1, true));
+
+  for (size_t set = 0; set < buffers.rangeCount * c_animationHandCount; set++) {
+    for (size_t keyframe = 0; keyframe < keyframeCount; keyframe++) {
+      for (size_t bone = 0; bone < c_animationBoneCount; bone++) {
+        const float* rotation = buffers.GetKeyframeRotation(set, keyframe, bone);
+        std::transform(
+            rotation,
+            rotation + c_keyframeRotationStride,
+            &rotations[AnimationModel::GetQuantizedRotationIndex(keyframeCount, set, keyframe, bone)],
+            QuantizeRotationComponent);
+
+        std::copy_n(
+            buffers.GetKeyframeTranslation(set, keyframe, bone),
+            c_keyframeTranslationStride,
+            &translations[AnimationModel::GetKeyframeTranslationIndex(keyframeCount, 1, true, set, keyframe, bone)]);
+      }
+    }
+  }
+
+  buffers.keyframeData = std::move(translations);
+  buffers.quantizedRotations = std::move(rotations);
+}
+
+// a component of an accessor as a float. Normalised integers are scaled to 0 -> 1, or -1 -> 1 if they're signed, as the gltf spec has it
+static float ReadAccessorComponent(const unsigned char* data, const int componentType, const bool normalized) {
+  const auto read = [data]<typename T>(T value) {
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  };
+
+  switch (componentType) {
+    case TINYGLTF_COMPONENT_TYPE_BYTE: {
+      const float value = read(int8_t{});
+      return normalized ? std::max(value / 127.0f, -1.0f) : value;
+    }
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+      const float value = read(uint8_t{});
+      return normalized ? value / 255.0f : value;
+    }
+    case TINYGLTF_COMPONENT_TYPE_SHORT: {
+      const float value = read(int16_t{});
+      return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+    }
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+      const float value = read(uint16_t{});
+      return normalized ? value / 65535.0f : value;
+    }
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
+      return static_cast<float>(read(uint32_t{}));
+    }
+    default: {
+      return read(float{});
+    }
+  }
+}
+
+// the index a sparse accessor substitutes a value at, which is always an unsigned integer
+static size_t ReadSparseIndex(const unsigned char* data, const int componentType) {
+  switch (componentType) {
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+      return *data;
+    }
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+      uint16_t index;
+      std::memcpy(&index, data, sizeof(index));
+      return index;
+    }
+    default: {
+      uint32_t index;
+      std::memcpy(&index, data, sizeof(index));
+      return index;
+    }
+  }
+}
+
+// the bytes of a buffer view from offset on, or nullptr if they don't hold size bytes
+static const unsigned char* GetBufferViewData(const tinygltf::Model& model, const int bufferViewIndex, const size_t offset, const size_t size) {
+  if (bufferViewIndex < 0 || static_cast<size_t>(bufferViewIndex) >= model.bufferViews.size()) return nullptr;
+
+  const tinygltf::BufferView& bufferView = model.bufferViews[bufferViewIndex];
+  if (bufferView.buffer < 0 || static_cast<size_t>(bufferView.buffer) >= model.buffers.size()) return nullptr;
+
+  const std::vector<unsigned char>& data = model.buffers[bufferView.buffer].data;
+  if (offset + size > bufferView.byteLength || bufferView.byteOffset + bufferView.byteLength > data.size()) return nullptr;
+
+  return data.data() + bufferView.byteOffset + offset;
+}
+
+// every element of an accessor of N components as floats, whatever their type and however far apart they're stored, with the values of a sparse
+// accessor substituted in. Empty if the accessor isn't N components or doesn't fit in its buffers
+template <size_t N>
+static std::vector<std::array<float, N>> ReadAccessor(const tinygltf::Model& model, const tinygltf::Accessor& accessor) {
+  const int componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+  if (componentSize <= 0 || tinygltf::GetNumComponentsInType(accessor.type) != static_cast<int>(N) || accessor.count == 0) return {};
+
+  const size_t elementSize = static_cast<size_t>(componentSize) * N;
+  std::vector<std::array<float, N>> result(accessor.count);
+
+  const auto readElement = [&](const unsigned char* data, std::array<float, N>& element) {
+    for (size_t i = 0; i < N; i++) element[i] = ReadAccessorComponent(data + i * componentSize, accessor.componentType, accessor.normalized);
+  };
+
+  // a sparse accessor without a buffer view starts out as all zeros
+  if (accessor.bufferView >= 0) {
+    if (static_cast<size_t>(accessor.bufferView) >= model.bufferViews.size()) return {};
+
+    const int byteStride = accessor.ByteStride(model.bufferViews[accessor.bufferView]);
+    if (byteStride <= 0) return {};
+
+    const size_t stride = static_cast<size_t>(byteStride);
+    const unsigned char* data = GetBufferViewData(model, accessor.bufferView, accessor.byteOffset, (accessor.count - 1) * stride + elementSize);
+    if (data == nullptr) return {};
+
+    for (size_t element = 0; element < accessor.count; element++) readElement(data + element * stride, result[element]);
+  } else if (!accessor.sparse.isSparse) {
+    return {};
+  }
+
+  if (accessor.sparse.isSparse && accessor.sparse.count > 0) {
+    const size_t count = static_cast<size_t>(accessor.sparse.count);
+    const int indexComponentType = accessor.sparse.indices.componentType;
+    const int indexSize = tinygltf::GetComponentSizeInBytes(indexComponentType);
+    if (indexSize <= 0) return {};
+
+    // indices and values are both tightly packed
+    const unsigned char* indices = GetBufferViewData(
+        model, accessor.sparse.indices.bufferView, static_cast<size_t>(accessor.sparse.indices.byteOffset), count * indexSize);
+    const unsigned char* values =
+        GetBufferViewData(model, accessor.sparse.values.bufferView, static_cast<size_t>(accessor.sparse.values.byteOffset), count * elementSize);
+    if (indices == nullptr || values == nullptr) return {};
+
+    for (size_t i = 0; i < count; i++) {
+      const size_t element = ReadSparseIndex(indices + i * indexSize, indexComponentType);
+      if (element >= result.size()) return {};
+
+      readElement(values + i * elementSize, result[element]);
+    }
+  }
+
+  return result;
+}
+
+static std::vector<float> ReadScalarAccessor(const tinygltf::Model& model, const tinygltf::Accessor& accessor) {
+  std::vector<float> result;
+  for (const std::array<float, 1>& element : ReadAccessor<1>(model, accessor)) result.push_back(element[0]);
+
+  return result;
+}
+
+// every range is evaluated at the keyframe times of the animation without a controller
+static bool LoadKeyframeTimes(const tinygltf::Model& model, const tinygltf::Animation& animation, AnimationModelBuffers& result) {
+  if (animation.samplers.empty()) return false;
+
+  result.keyframeTimes = ReadScalarAccessor(model, model.accessors[animation.samplers[0].input]);
+
+  return !result.keyframeTimes.empty();
+}
+
+// the value of a channel at time, interpolated between the keyframes either side of it. Rotations take the shortest path and are normalised,
+// and at a keyframe's own time its value is returned exactly
+template <size_t N>
+static std::array<float, N> SampleChannel(const std::vector<float>& times, const std::vector<std::array<float, N>>& values, const float time) {
+  const size_t count = std::min(times.size(), values.size());
+
+  const size_t upper = std::upper_bound(times.begin(), times.begin() + count, time) - times.begin();
+  if (upper == 0) return values[0];
+  if (upper >= count) return values[count - 1];
+
+  const std::array<float, N>& start = values[upper - 1];
+  const std::array<float, N>& end = values[upper];
+  const float interp = (time - times[upper - 1]) / (times[upper] - times[upper - 1]);
+  if (interp <= 0.0f) return start;
+
+  float sign = 1.0f;
+  if constexpr (N == 4) {
+    float dot = 0.0f;
+    for (size_t i = 0; i < N; i++) dot += start[i] * end[i];
+    if (dot < 0.0f) sign = -1.0f;
+  }
+
+  std::array<float, N> result;
+  for (size_t i = 0; i < N; i++) result[i] = Lerp(start[i], sign * end[i], interp);
+
+  if constexpr (N == 4) {
+    float lengthSq = 0.0f;
+    for (size_t i = 0; i < N; i++) lengthSq += result[i] * result[i];
+
+    const float invLength = 1.0f / std::sqrt(std::max(lengthSq, 1e-12f));
+    for (size_t i = 0; i < N; i++) result[i] *= invLength;
+  }
+
+  return result;
+}
+
+enum class ChannelInterpolation {
+  Linear,
+  Step,
+  CubicSpline,
+};
+
+static ChannelInterpolation GetChannelInterpolation(const tinygltf::AnimationSampler& sampler) {
+  if (sampler.interpolation == "STEP") return ChannelInterpolation::Step;
+  if (sampler.interpolation == "CUBICSPLINE") return ChannelInterpolation::CubicSpline;
+
+  return ChannelInterpolation::Linear;
+}
+
+// a channel of an animation, as it is in the model. Cubic splines also have the tangents either side of each keyframe, per second
+template <size_t N>
+struct AnimationCurve {
+  ChannelInterpolation interpolation;
+  std::vector<float> times;
+  std::vector<std::array<float, N>> values;
+  std::vector<std::array<float, N>> inTangents;
+  std::vector<std::array<float, N>> outTangents;
+};
+
+template <size_t N>
+static AnimationCurve<N> LoadCurve(const tinygltf::Model& model, const tinygltf::AnimationSampler& sampler) {
+  AnimationCurve<N> curve;
+  curve.interpolation = GetChannelInterpolation(sampler);
+  curve.times = ReadScalarAccessor(model, model.accessors[sampler.input]);
+
+  std::vector<std::array<float, N>> output = ReadAccessor<N>(model, model.accessors[sampler.output]);
+
+  if (curve.interpolation == ChannelInterpolation::CubicSpline) {
+    // each keyframe is its in tangent, value and out tangent
+    for (size_t i = 0; i + 2 < output.size(); i += 3) {
+      curve.inTangents.push_back(output[i]);
+      curve.values.push_back(output[i + 1]);
+      curve.outTangents.push_back(output[i + 2]);
+    }
+  } else {
+    curve.values = std::move(output);
+  }
+
+  const size_t count = std::min(curve.times.size(), curve.values.size());
+  curve.times.resize(count);
+  curve.values.resize(count);
+  if (curve.interpolation == ChannelInterpolation::CubicSpline) {
+    curve.inTangents.resize(count);
+    curve.outTangents.resize(count);
+  }
+
+  return curve;
+}
+
+// flip each rotation of a linear curve to the same side as the one before it, so that interpolating its components goes the short way around
+static void AlignCurveRotations(AnimationCurve<4>& curve) {
+  if (curve.interpolation != ChannelInterpolation::Linear) return;
+
+  for (size_t i = 1; i < curve.values.size(); i++) {
+    std::array<float, 4>& rotation = curve.values[i];
+    const std::array<float, 4>& previous = curve.values[i - 1];
+
+    if (rotation[0] * previous[0] + rotation[1] * previous[1] + rotation[2] * previous[2] + rotation[3] * previous[3] < 0.0f)
+      for (float& component : rotation) component = -component;
+  }
+}
+
+// the value of a curve at time and how fast it's changing per second, between the curve's keyframes segment and segment + 1. Before the first or
+// after the last segment it holds its first or last value
+template <size_t N>
+static void EvaluateCurveSegment(
+    const AnimationCurve<N>& curve, const ptrdiff_t segment, const float time, std::array<float, N>& value, std::array<float, N>& rate) {
+  rate.fill(0.0f);
+
+  if (segment < 0) {
+    value = curve.values.front();
+    return;
+  }
+  if (segment >= static_cast<ptrdiff_t>(curve.values.size()) - 1) {
+    value = curve.values.back();
+    return;
+  }
+
+  const std::array<float, N>& start = curve.values[segment];
+  const std::array<float, N>& end = curve.values[segment + 1];
+  const float duration = curve.times[segment + 1] - curve.times[segment];
+
+  if (!(duration > 0.0f)) {
+    value = end;
+    return;
+  }
+
+  const float t = std::clamp((time - curve.times[segment]) / duration, 0.0f, 1.0f);
+
+  switch (curve.interpolation) {
+    case ChannelInterpolation::Step: {
+      value = start;
+      return;
+    }
+
+    case ChannelInterpolation::Linear: {
+      for (size_t i = 0; i < N; i++) {
+        value[i] = Lerp(start[i], end[i], t);
+        rate[i] = (end[i] - start[i]) / duration;
+      }
+      return;
+    }
+
+    case ChannelInterpolation::CubicSpline: {
+      const float t2 = t * t;
+      const float t3 = t2 * t;
+
+      for (size_t i = 0; i < N; i++) {
+        const float startTangent = curve.outTangents[segment][i] * duration;
+        const float endTangent = curve.inTangents[segment + 1][i] * duration;
+
+        value[i] = (2.0f * t3 - 3.0f * t2 + 1.0f) * start[i] + (t3 - 2.0f * t2 + t) * startTangent + (3.0f * t2 - 2.0f * t3) * end[i] +
+                   (t3 - t2) * endTangent;
+        rate[i] = ((6.0f * t2 - 6.0f * t) * start[i] + (3.0f * t2 - 4.0f * t + 1.0f) * startTangent + (6.0f * t - 6.0f * t2) * end[i] +
+                   (3.0f * t2 - 2.0f * t) * endTangent) /
+                  duration;
+      }
+      return;
+    }
+  }
+}
+
+template <size_t N>
+using CurveCoefficients = std::array<std::array<float, N>, c_hermiteCoefficientCount>;
+
+// the cubic c0 + c1 t + c2 t^2 + c3 t^3 that follows a curve from time start (t = 0) to time end (t = 1). It matches the value and rate of
+// change of the curve at both ends, so is exact for a linear, step or cubic spline piece of the curve, and a smooth fit across any of the
+// curve's own keyframes that fall in between. If end isn't after start, it holds the curve's value at start
+template <size_t N>
+static CurveCoefficients<N> GetCurveCoefficients(const AnimationCurve<N>& curve, const float start, const float end) {
+  // the curve's segment start is in and the one end is in, from the left, so that a step that lands on end isn't taken until the next
+  const ptrdiff_t startSegment = std::upper_bound(curve.times.begin(), curve.times.end(), start) - curve.times.begin() - 1;
+  const ptrdiff_t endSegment = std::lower_bound(curve.times.begin(), curve.times.end(), end) - curve.times.begin() - 1;
+
+  std::array<float, N> startValue, startRate, endValue, endRate;
+  EvaluateCurveSegment(curve, startSegment, start, startValue, startRate);
+  EvaluateCurveSegment(curve, endSegment, end, endValue, endRate);
+
+  CurveCoefficients<N> result{};
+  const float duration = end - start;
+
+  if (!(duration > 0.0f)) {
+    result[0] = startValue;
+    return result;
+  }
+
+  for (size_t i = 0; i < N; i++) {
+    const float startTangent = startRate[i] * duration;
+    const float endTangent = endRate[i] * duration;
+
+    result[0][i] = startValue[i];
+    result[1][i] = startTangent;
+    result[2][i] = 3.0f * (endValue[i] - startValue[i]) - 2.0f * startTangent - endTangent;
+    result[3][i] = 2.0f * (startValue[i] - endValue[i]) + startTangent + endTangent;
+  }
+
+  return result;
+}
+
+// the initial transforms of the right hand, as they are in the model
+static void LoadInitialTransforms(const tinygltf::Model& model, std::vector<Transform>& initialTransforms) {
+  const size_t right = AnimationModel::GetHandIndex(true);
+
+  for (size_t nodeIndex = 0; nodeIndex < model.nodes.size(); nodeIndex++) {
+    const tinygltf::Node& node = model.nodes[nodeIndex];
+
+    const auto it = GLTFNodeBoneMap.find(node.name);
+    if (it == GLTFNodeBoneMap.end()) {
+      DriverLog("Not parsing node as it was not defined as a bone: %i", nodeIndex);
+      continue;
+    }
+
+    Transform transform;
+    if (node.rotation.size() >= 4) {
+      transform.rotation[0] = static_cast<float>(node.rotation[0]);
+      transform.rotation[1] = static_cast<float>(node.rotation[1]);
+      transform.rotation[2] = static_cast<float>(node.rotation[2]);
+      transform.rotation[3] = static_cast<float>(node.rotation[3]);
+      MapRotation(transform.rotation);
+    }
+    if (node.translation.size() >= 3) {
+      transform.translation[0] = static_cast<float>(node.translation[0]);
+      transform.translation[1] = static_cast<float>(node.translation[1]);
+      transform.translation[2] = static_cast<float>(node.translation[2]);
+    }
+    MapRightTransform(transform, it->second);
+
+    initialTransforms[right * c_animationBoneCount + static_cast<size_t>(it->second)] = transform;
+  }
+}
+
+// the animation of the right hand for a range, as it is in the model, sampled at the keyframe times
+static void LoadAnimation(
+    const tinygltf::Model& model,
+    const tinygltf::Animation& animation,
+    const AnimationRange range,
+    const std::vector<Transform>& initialTransforms,
+    AnimationModelBuffers& result) {
+  const size_t right = AnimationModel::GetHandIndex(true);
+  const size_t set = AnimationModel::GetKeyframeSet(range, true);
+  const size_t keyframeCount = result.keyframeTimes.size();
+  const bool hermite = result.coefficientCount == c_hermiteCoefficientCount;
+
+  // bones without a channel for rotation or translation hold their initial transform through the animation. As coefficients, that's all in
+  // the constant term with the rest left at 0
+  for (size_t bone = 0; bone < c_animationBoneCount; bone++) {
+    const Transform& transform = initialTransforms[right * c_animationBoneCount + bone];
+
+    for (size_t i = 0; i < keyframeCount; i++) {
+      std::copy(transform.rotation.begin(), transform.rotation.end(), result.GetKeyframeRotation(set, i, bone));
+      std::copy(transform.translation.begin(), transform.translation.end(), result.GetKeyframeTranslation(set, i, bone));
+    }
+  }
+
+  for (auto& channel : animation.channels) {
+    if (channel.target_node < 0 || static_cast<size_t>(channel.target_node) >= model.nodes.size()) continue;
+
+    const auto it = GLTFNodeBoneMap.find(model.nodes[channel.target_node].name);
+    if (it == GLTFNodeBoneMap.end()) continue;
+
+    const HandSkeletonBone bone = it->second;
+    const size_t boneIndex = static_cast<size_t>(bone);
+
+    const tinygltf::AnimationSampler& sampler = animation.samplers[channel.sampler];
+
+    switch (model.accessors[sampler.output].type) {
+      // rotation via quaternion
+      case TINYGLTF_TYPE_VEC4: {
+        AnimationCurve<4> curve = LoadCurve<4>(model, sampler);
+        if (curve.values.empty()) break;
+
+        if (!hermite) {
+          for (size_t i = 0; i < keyframeCount; i++) {
+            std::array<float, 4> keyframe = SampleChannel(curve.times, curve.values, result.keyframeTimes[i]);
+            MapRotation(keyframe);
+            std::copy(keyframe.begin(), keyframe.end(), result.GetKeyframeRotation(set, i, boneIndex));
+          }
+          break;
+        }
+
+        AlignCurveRotations(curve);
+        for (size_t i = 0; i < keyframeCount; i++) {
+          CurveCoefficients<4> coefficients =
+              GetCurveCoefficients(curve, result.keyframeTimes[i], result.keyframeTimes[std::min(i + 1, keyframeCount - 1)]);
+
+          float* destination = result.GetKeyframeRotation(set, i, boneIndex);
+          for (size_t c = 0; c < c_hermiteCoefficientCount; c++) {
+            MapRotation(coefficients[c]);
+            std::copy(coefficients[c].begin(), coefficients[c].end(), destination + c * c_keyframeRotationStride);
+          }
+        }
+        break;
+      }
+      // translation
+      case TINYGLTF_TYPE_VEC3: {
+        const AnimationCurve<3> curve = LoadCurve<3>(model, sampler);
+        if (curve.values.empty()) break;
+
+        if (!hermite) {
+          for (size_t i = 0; i < keyframeCount; i++) {
+            Transform keyframe;
+            keyframe.translation = SampleChannel(curve.times, curve.values, result.keyframeTimes[i]);
+            MapRightTransform(keyframe, bone);
+            std::copy(keyframe.translation.begin(), keyframe.translation.end(), result.GetKeyframeTranslation(set, i, boneIndex));
+          }
+          break;
+        }
+
+        for (size_t i = 0; i < keyframeCount; i++) {
+          const CurveCoefficients<3> coefficients =
+              GetCurveCoefficients(curve, result.keyframeTimes[i], result.keyframeTimes[std::min(i + 1, keyframeCount - 1)]);
+
+          // mapping only flips signs, so maps each coefficient the same as it would the value. The padding stays 1 in the constant term only
+          float* destination = result.GetKeyframeTranslation(set, i, boneIndex);
+          for (size_t c = 0; c < c_hermiteCoefficientCount; c++) {
+            Transform keyframe;
+            keyframe.translation = coefficients[c];
+            MapRightTransform(keyframe, bone);
+            std::copy(keyframe.translation.begin(), keyframe.translation.end(), destination + c * c_keyframeTranslationStride);
+          }
+        }
+        break;
+      }
+    }
+  }
+}
+
+// the parsed gltf model is only needed while we pull the animation out of it, and is released when this returns
+std::shared_ptr<AnimationModel> LoadGLTFAnimationModel(const std::string& fileName) {
+  tinygltf::Model model;
   tinygltf::TinyGLTF loader;
   std::string err;
   std::string warn;
 
-  const bool ret = loader.LoadBinaryFromFile(&model_, &err, &warn, fileName_);
+  const bool ret = loader.LoadBinaryFromFile(&model, &err, &warn, fileName);
 
   if (!warn.empty()) {
     DriverLog("Warning parsing gltf file: %s", warn.c_str());
-    return false;
+    return nullptr;
   }
 
   if (!err.empty()) {
     DriverLog("Error parsing gltf file: %s", err.c_str());
-    return false;
+    return nullptr;
   }
 
   if (!ret) {
     DriverLog("Failed to parse gltf");
+    return nullptr;
+  }
+
+  if (model.animations.empty()) {
+    DriverLog("No animations in gltf file");
+    return nullptr;
+  }
+
+  // the controller animation is matched by name, and the open hand uses the first of the others (or the only animation, whatever it's called)
+  const auto isControllerAnimation = [](const tinygltf::Animation& animation) { return animation.name == c_controllerAnimationName; };
+  const auto controllerAnimation = std::find_if(model.animations.begin(), model.animations.end(), isControllerAnimation);
+  const auto openAnimation = std::find_if_not(model.animations.begin(), model.animations.end(), isControllerAnimation);
+
+  const tinygltf::Animation& withoutController = openAnimation != model.animations.end() ? *openAnimation : model.animations[0];
+  const tinygltf::Animation* withController =
+      controllerAnimation != model.animations.end() && &*controllerAnimation != &withoutController ? &*controllerAnimation : nullptr;
+
+  std::vector<Transform> initialTransforms(c_animationBoneCount * c_animationHandCount);
+  AnimationModelBuffers buffers;
+  buffers.rangeCount = withController != nullptr ? c_animationRangeCount : 1;
+
+  // the keyframes of a model that only interpolates linearly are its values, anything else needs the coefficients of a cubic
+  const auto isLinear = [](const tinygltf::Animation* animation) {
+    return animation == nullptr || std::ranges::all_of(animation->samplers, [](const tinygltf::AnimationSampler& sampler) {
+             return GetChannelInterpolation(sampler) == ChannelInterpolation::Linear;
+           });
+  };
+  buffers.coefficientCount = isLinear(&withoutController) && isLinear(withController) ? 1 : c_hermiteCoefficientCount;
+
+  // rotations authored as normalised integers lose nothing being kept as 16 bit integers, as long as they're values rather than the coefficients
+  // of a cubic
+  const auto isRotation = [&model](const tinygltf::AnimationSampler& sampler) { return model.accessors[sampler.output].type == TINYGLTF_TYPE_VEC4; };
+  const auto isQuantized = [&model](const tinygltf::AnimationSampler& sampler) {
+    const tinygltf::Accessor& output = model.accessors[sampler.output];
+    return output.normalized && (output.componentType == TINYGLTF_COMPONENT_TYPE_BYTE || output.componentType == TINYGLTF_COMPONENT_TYPE_SHORT);
+  };
+  const auto hasQuantizedRotations = [&](const tinygltf::Animation* animation) {
+    return animation == nullptr || std::ranges::all_of(animation->samplers | std::views::filter(isRotation), isQuantized);
+  };
+  const bool quantizeRotations = buffers.coefficientCount == 1 &&
+                                 std::ranges::any_of(withoutController.samplers | std::views::filter(isRotation), isQuantized) &&
+                                 hasQuantizedRotations(&withoutController) && hasQuantizedRotations(withController);
+
+  if (!LoadKeyframeTimes(model, withoutController, buffers)) {
+    DriverLog("Animation %s has no keyframes", withoutController.name.c_str());
+    return nullptr;
+  }
+  buffers.keyframeData = CreateKeyframeData(buffers.keyframeTimes.size(), buffers.rangeCount, buffers.coefficientCount);
+
+  LoadInitialTransforms(model, initialTransforms);
+  LoadAnimation(model, withoutController, AnimationRange::WithoutController, initialTransforms, buffers);
+  if (withController != nullptr) {
+    LoadAnimation(model, *withController, AnimationRange::WithController, initialTransforms, buffers);
+    DriverLog("Using animation %s while holding a controller", withController->name.c_str());
+  }
+  MirrorInitialTransforms(initialTransforms);
+  MirrorKeyframes(buffers);
+  if (quantizeRotations) QuantizeKeyframeRotations(buffers);
+
+  return CreateAnimationModel(std::move(initialTransforms), std::move(buffers), false);
+}
+
+static float GetMaxComponentError(const vr::VRBoneTransform_t& a, const vr::VRBoneTransform_t& b) {
+  return std::max(
+      {std::abs(a.orientation.w - b.orientation.w),
+       std::abs(a.orientation.x - b.orientation.x),
+       std::abs(a.orientation.y - b.orientation.y),
+       std::abs(a.orientation.z - b.orientation.z),
+       std::abs(a.position.v[0] - b.position.v[0]),
+       std::abs(a.position.v[1] - b.position.v[1]),
+       std::abs(a.position.v[2] - b.position.v[2])});
+}
+
+std::shared_ptr<AnimationModel> BakeAnimationModel(const AnimationModel& model, int resolution) {
+  if (resolution < c_minBakeResolution || resolution > c_maxBakeResolution) {
+    DriverLog("Animation bake resolution %i is outside of %i-%i, evaluating keyframes directly", resolution, c_minBakeResolution, c_maxBakeResolution);
+    return nullptr;
+  }
+
+  const std::span<const float> keyframeTimes = model.keyframeTimes;
+  if (keyframeTimes.size() < 2) return nullptr;
+
+  // if the keyframes are evenly spaced, line the steps up with them so that the table reproduces the animation exactly
+  const float keyframeSpacing = keyframeTimes[1] - keyframeTimes[0];
+  bool evenlySpaced = keyframeTimes[0] == 0.0f && keyframeSpacing > 0.0f;
+  for (size_t i = 1; evenlySpaced && i < keyframeTimes.size(); i++)
+    evenlySpaced = std::abs(keyframeTimes[i] - keyframeTimes[i - 1] - keyframeSpacing) < keyframeSpacing * 1e-3f;
+
+  const int keyframesPerUnit = static_cast<int>(std::round(1.0f / keyframeSpacing));
+  if (evenlySpaced && keyframesPerUnit > 0 && std::abs(1.0f / keyframeSpacing - static_cast<float>(keyframesPerUnit)) < 1e-3f) {
+    const int alignedResolution = (resolution + keyframesPerUnit - 2) / keyframesPerUnit * keyframesPerUnit + 1;
+
+    if (alignedResolution != resolution) DriverLog("Rounding animation bake resolution up from %i to %i to match the keyframes", resolution, alignedResolution);
+    resolution = alignedResolution;
+  }
+
+  AnimationModelBuffers buffers;
+  buffers.rangeCount = model.rangeCount;
+  buffers.keyframeData = CreateKeyframeData(resolution, buffers.rangeCount, buffers.coefficientCount);
+
+  buffers.keyframeTimes.resize(resolution);
+  for (int step = 0; step < resolution; step++) buffers.keyframeTimes[step] = static_cast<float>(step) / static_cast<float>(resolution - 1);
+
+  std::vector<KeyframeInterval> intervals(c_animationBoneCount);
+  std::vector<vr::VRBoneTransform_t> transforms(c_animationBoneCount * c_animationRangeCount);
+
+  for (int step = 0; step < resolution; step++) {
+    std::fill(intervals.begin(), intervals.end(), model.GetKeyframeInterval(buffers.keyframeTimes[step]));
+    model.GetTransforms(intervals.data(), true, transforms.data(), transforms.data() + c_animationBoneCount);
+
+    // the left hand is mirrored from the right hand afterwards, the same as when it's loaded
+    for (size_t range = 0; range < buffers.rangeCount; range++) {
+      const size_t right = AnimationModel::GetKeyframeSet(static_cast<AnimationRange>(range), true);
+
+      for (size_t bone = 0; bone < c_animationBoneCount; bone++) {
+        const vr::VRBoneTransform_t& transform = transforms[range * c_animationBoneCount + bone];
+
+        float* rotation = buffers.GetKeyframeRotation(right, step, bone);
+        rotation[0] = transform.orientation.w;
+        rotation[1] = transform.orientation.x;
+        rotation[2] = transform.orientation.y;
+        rotation[3] = transform.orientation.z;
+
+        float* translation = buffers.GetKeyframeTranslation(right, step, bone);
+        translation[0] = transform.position.v[0];
+        translation[1] = transform.position.v[1];
+        translation[2] = transform.position.v[2];
+      }
+    }
+  }
+
+  MirrorKeyframes(buffers);
+
+  // a quantized model bakes to a quantized table, which the error check below accounts for
+  if (!model.quantizedRotations.empty()) QuantizeKeyframeRotations(buffers);
+
+  const std::shared_ptr<AnimationModel> baked = CreateAnimationModel(model.initialTransforms, std::move(buffers), true);
+
+  // the table only approximates the keyframed animation between steps, so make sure it's close enough before we use it
+  std::vector<vr::VRBoneTransform_t> bakedTransforms(c_animationBoneCount * c_animationRangeCount);
+  const int errorSamples = (resolution - 1) * c_bakeErrorSamplesPerStep;
+
+  float maxError = 0.0f;
+  for (int sample = 0; sample <= errorSamples; sample++) {
+    const float time = static_cast<float>(sample) / static_cast<float>(errorSamples);
+
+    std::fill(intervals.begin(), intervals.end(), model.GetKeyframeInterval(time));
+    model.GetTransforms(intervals.data(), true, transforms.data(), transforms.data() + c_animationBoneCount);
+
+    std::fill(intervals.begin(), intervals.end(), baked->GetKeyframeInterval(time));
+    baked->GetTransforms(intervals.data(), true, bakedTransforms.data(), bakedTransforms.data() + c_animationBoneCount);
+
+    for (size_t i = 0; i < transforms.size(); i++) maxError = std::max(maxError, GetMaxComponentError(transforms[i], bakedTransforms[i]));
+  }
+
+  if (!(maxError <= c_maxBakeError)) {
+    DriverLog("Baked animation error %f exceeds %f at resolution %i, evaluating keyframes directly", maxError, c_maxBakeError, resolution);
+    return nullptr;
+  }
+
+  DriverLog("Baked animation at %i steps per bone, max error %f", resolution, maxError);
+
+  return baked;
+}
+
+struct ModelCacheKey {
+  std::string fileName;
+  std::filesystem::file_time_type lastWriteTime;
+  int bakeResolution;
+
+  bool operator<(const ModelCacheKey& other) const {
+    return std::tie(fileName, lastWriteTime, bakeResolution) < std::tie(other.fileName, other.lastWriteTime, other.bakeResolution);
+  }
+};
+
+// the cache doesn't keep models alive itself, so a model is freed once the last device using it goes away
+static std::mutex modelCacheMutex;
+static std::map<ModelCacheKey, std::weak_ptr<const AnimationModel>> modelCache;
+
+bool GLTFModelManager::Load() {
+  std::error_code error;
+  const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(fileName_, error);
+  if (error) {
+    DriverLog("Failed to read animation file %s: %s", fileName_.c_str(), error.message().c_str());
     return false;
   }
 
-  initialTransforms_ = std::vector<Transform>(GLTFNodeBoneMap.size());
-  keyframeTransforms_ = std::vector<std::vector<Transform>>(GLTFNodeBoneMap.size());
+  std::lock_guard<std::mutex> lock(modelCacheMutex);
+
+  std::erase_if(modelCache, [](const auto& entry) { return entry.second.expired(); });
+
+  const ModelCacheKey key{fileName_, lastWriteTime, bakeResolution_};
+  if (const auto it = modelCache.find(key); it != modelCache.end()) {
+    model_ = it->second.lock();
+    return true;
+  }
+
+  std::shared_ptr<AnimationModel> model = LoadAnimationBlob(GetAnimationBlobPath(fileName_), fileName_);
+  if (model == nullptr) model = LoadGLTFAnimationModel(fileName_);
+  if (model == nullptr) return false;
+
+  if (bakeResolution_ > 0) {
+    if (std::shared_ptr<AnimationModel> baked = BakeAnimationModel(*model, bakeResolution_)) model = std::move(baked);
+  }
+
+  DriverLog("Loaded animation %s using %zu bytes", fileName_.c_str(), model->GetMemoryUsage());
 
-  LoadKeyframeTimes();
-  LoadInitialTransforms();
+  modelCache[key] = model;
+  model_ = model;
 
   return true;
 }
 
-void GLTFModelManager::LoadKeyframeTimes() {
-  const tinygltf::Accessor accessor = model_.accessors[0];
-  keyframeTimes_.resize(accessor.count);
+KeyframeInterval GLTFModelManager::GetKeyframeInterval(const float f) const {
+  return model_->GetKeyframeInterval(f);
+}
 
-  const tinygltf::BufferView bufferView = model_.bufferViews[accessor.bufferView];
-  const std::vector<unsigned char>& bufData = model_.buffers[0].data;
-  memcpy(&keyframeTimes_[0], bufData.data() + bufferView.byteOffset + accessor.byteOffset, accessor.count * sizeof(float));
+void GLTFModelManager::GetTransforms(
+    const std::span<const size_t> bones,
+    const KeyframeInterval* intervals,
+    const bool rightHand,
+    vr::VRBoneTransform_t* transforms,
+    vr::VRBoneTransform_t* controllerTransforms) const {
+  model_->GetTransforms(bones, intervals, rightHand, transforms, controllerTransforms);
 }
 
-void GLTFModelManager::LoadInitialTransforms() {
-  for (size_t nodeIndex = 0; nodeIndex < model_.nodes.size(); nodeIndex++) {
-    const tinygltf::Node& node = model_.nodes[nodeIndex];
+Transform GLTFModelManager::GetTransformByBoneIndex(const HandSkeletonBone& boneIndex, const bool rightHand) const {
+  return model_->GetInitialTransform(static_cast<size_t>(boneIndex), rightHand);
+}
 
-    try {
-      const HandSkeletonBone bone = GLTFNodeBoneMap.at(node.name);
-      const int boneIndex = static_cast<int>(bone);
+KeyframeInterval AnimationModel::GetKeyframeInterval(const float f) const {
+  const size_t lastKeyframeIndex = keyframeTimes.size() - 1;
 
-      Transform transform;
-      if (node.rotation.size() >= 4) {
-        transform.rotation[0] = static_cast<float>(node.rotation[0]);
-        transform.rotation[1] = static_cast<float>(node.rotation[1]);
-        transform.rotation[2] = static_cast<float>(node.rotation[2]);
-        transform.rotation[3] = static_cast<float>(node.rotation[3]);
-        MapRotation(transform.rotation);
-      }
-      if (node.translation.size() >= 3) {
-        transform.translation[0] = static_cast<float>(node.translation[0]);
-        transform.translation[1] = static_cast<float>(node.translation[1]);
-        transform.translation[2] = static_cast<float>(node.translation[2]);
-      }
-      MapRightTransform(transform, (HandSkeletonBone)boneIndex);
+  if (baked) {
+    const float position = std::clamp(f, 0.0f, 1.0f) * static_cast<float>(lastKeyframeIndex);
+    const size_t lowerKeyframeIndex = std::min(static_cast<size_t>(position), lastKeyframeIndex - 1);
 
-      initialTransforms_[boneIndex] = transform;
+    return {lowerKeyframeIndex, lowerKeyframeIndex + 1, position - static_cast<float>(lowerKeyframeIndex)};
+  }
 
-      const tinygltf::Animation& animation = model_.animations[0];
-      std::vector<Transform>& transforms = keyframeTransforms_[boneIndex];
+  // upper bound of f in the keyframe times, without branching on them. The curls of a moving hand land between different keyframes every frame,
+  // so a search that branches mispredicts at almost every step
+  const float* first = keyframeTimes.data();
+  for (size_t length = keyframeTimes.size(); length > 1; length -= length / 2) first = first[length / 2] <= f ? first + length / 2 : first;
 
-      transforms.resize(keyframeTimes_.size());
+  const size_t upperKeyframeIndex = static_cast<size_t>(first - keyframeTimes.data()) + (*first <= f);
 
-      for (auto& channel : animation.channels) {
-        if (channel.target_node != nodeIndex) continue;
+  // hold the first or last keyframe outside of the animation
+  if (upperKeyframeIndex == 0) return {0, 0, 0.0f};
+  if (upperKeyframeIndex > lastKeyframeIndex) return {lastKeyframeIndex, lastKeyframeIndex, 0.0f};
 
-        const tinygltf::Accessor& accessor = model_.accessors[animation.samplers[channel.sampler].output];
-        switch (accessor.type) {
-          // rotation via quaternion
-          case TINYGLTF_TYPE_VEC4: {
-            std::vector<std::array<float, 4>> keyframes = GetVecN<4>(accessor);
-            for (size_t i = 0; i < keyframes.size(); i++) {
-              transforms[i].rotation = keyframes[i];
-              MapRotation(transforms[i].rotation);
-            };
-            break;
-          }
-          // translation
-          case TINYGLTF_TYPE_VEC3: {
-            std::vector<std::array<float, 3>> keyframes = GetVecN<3>(accessor);
-            for (size_t i = 0; i < keyframes.size(); i++) {
-              transforms[i].translation = keyframes[i];
-              MapRightTransform(transforms[i], bone);
-            };
-            break;
-          }
-        }
-      }
+  const size_t lowerKeyframeIndex = upperKeyframeIndex - 1;
+  const float interp = (f - keyframeTimes[lowerKeyframeIndex]) / (keyframeTimes[upperKeyframeIndex] - keyframeTimes[lowerKeyframeIndex]);
 
-    } catch (const std::out_of_range&) {
-      DriverLog("Not parsing node as it was not defined as a bone: %i", nodeIndex);
-      continue;
+  return {lowerKeyframeIndex, upperKeyframeIndex, std::clamp(interp, 0.0f, 1.0f)};
+}
+
+// normalise an interpolated rotation (wxyz) into the orientation of transform
+static inline void StoreBoneRotation(const Float4 rotation, vr::VRBoneTransform_t& transform) {
+  Float4Store(&transform.orientation.w, Normalize({rotation}).wxyz);
+}
+
+#if defined(OPENGLOVE_SIMD_SSE)
+static inline __m128 LoadRotation(const float* rotation) {
+  return _mm_loadu_ps(rotation);
+}
+
+// quantized rotations stay scaled up, as they're normalised once they're interpolated
+static inline __m128 LoadRotation(const int16_t* rotation) {
+  const __m128i components = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(rotation));
+
+  // each component into the top half of a 32 bit lane, then shifted back down to sign extend it
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(components, components), 16));
+}
+
+// c0 + t (c1 + t (c2 + t c3)) for 4 coefficients one after another
+static inline __m128 EvaluateCubic(const float* coefficients, const __m128 t) {
+  __m128 result = _mm_loadu_ps(coefficients + 12);
+  result = _mm_add_ps(_mm_loadu_ps(coefficients + 8), _mm_mul_ps(t, result));
+  result = _mm_add_ps(_mm_loadu_ps(coefficients + 4), _mm_mul_ps(t, result));
+  return _mm_add_ps(_mm_loadu_ps(coefficients), _mm_mul_ps(t, result));
+}
+#elif defined(OPENGLOVE_SIMD_NEON)
+static inline float32x4_t LoadRotation(const float* rotation) {
+  return vld1q_f32(rotation);
+}
+
+// quantized rotations stay scaled up, as they're normalised once they're interpolated
+static inline float32x4_t LoadRotation(const int16_t* rotation) {
+  return vcvtq_f32_s32(vmovl_s16(vld1_s16(rotation)));
+}
+
+// c0 + t (c1 + t (c2 + t c3)) for 4 coefficients one after another
+static inline float32x4_t EvaluateCubic(const float* coefficients, const float t) {
+  float32x4_t result = vld1q_f32(coefficients + 12);
+  result = vmlaq_n_f32(vld1q_f32(coefficients + 8), result, t);
+  result = vmlaq_n_f32(vld1q_f32(coefficients + 4), result, t);
+  return vmlaq_n_f32(vld1q_f32(coefficients), result, t);
+}
+#else
+static void StoreBoneRotation(const float* rotation, vr::VRBoneTransform_t& transform) {
+  StoreBoneRotation(Float4Load(rotation), transform);
+}
+
+// quantized rotations stay scaled up, as they're normalised once they're interpolated
+template <typename Component>
+static void LoadRotation(const Component* rotation, float* result) {
+  for (size_t i = 0; i < 4; i++) result[i] = static_cast<float>(rotation[i]);
+}
+
+// c0 + t (c1 + t (c2 + t c3)) for each of 4 components, with the coefficients one after another
+static void EvaluateCubic(const float* coefficients, const float t, float* result) {
+  for (size_t i = 0; i < 4; i++) result[i] = coefficients[i] + t * (coefficients[4 + i] + t * (coefficients[8 + i] + t * coefficients[12 + i]));
+}
+#endif
+
+// lerp the translation, and nlerp the rotation along the shortest path, of a bone between two keyframes.
+// Translations are xyz1 and rotations wxyz, either floats or quantized, so each is one 4 wide register and the result is written straight over
+// the position and orientation of the transform
+template <typename RotationComponent>
+static void InterpolateBoneTransform(
+    const float* startTranslation,
+    const float* endTranslation,
+    const RotationComponent* startRotation,
+    const RotationComponent* endRotation,
+    const float interp,
+    vr::VRBoneTransform_t& transform) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  const __m128 t = _mm_set1_ps(interp);
+
+  const __m128 translationStart = _mm_loadu_ps(startTranslation);
+  _mm_storeu_ps(transform.position.v, _mm_add_ps(translationStart, _mm_mul_ps(t, _mm_sub_ps(_mm_loadu_ps(endTranslation), translationStart))));
+
+  const __m128 rotationStart = LoadRotation(startRotation);
+  __m128 rotationEnd = LoadRotation(endRotation);
+
+  // dot product, summed into every lane
+  __m128 dot = _mm_mul_ps(rotationStart, rotationEnd);
+  dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(2, 3, 0, 1)));
+  dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(1, 0, 3, 2)));
+
+  // q and -q are the same rotation, flip the end so we don't go the long way around
+  rotationEnd = _mm_xor_ps(rotationEnd, _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), _mm_set1_ps(-0.0f)));
+
+  StoreBoneRotation(_mm_add_ps(rotationStart, _mm_mul_ps(t, _mm_sub_ps(rotationEnd, rotationStart))), transform);
+#elif defined(OPENGLOVE_SIMD_NEON)
+  const float32x4_t translationStart = vld1q_f32(startTranslation);
+  vst1q_f32(transform.position.v, vmlaq_n_f32(translationStart, vsubq_f32(vld1q_f32(endTranslation), translationStart), interp));
+
+  const float32x4_t rotationStart = LoadRotation(startRotation);
+  float32x4_t rotationEnd = LoadRotation(endRotation);
+
+  // q and -q are the same rotation, flip the end so we don't go the long way around
+  if (vaddvq_f32(vmulq_f32(rotationStart, rotationEnd)) < 0.0f) rotationEnd = vnegq_f32(rotationEnd);
+
+  StoreBoneRotation(vmlaq_n_f32(rotationStart, vsubq_f32(rotationEnd, rotationStart), interp), transform);
+#else
+  for (size_t i = 0; i < c_keyframeTranslationStride; i++) transform.position.v[i] = Lerp(startTranslation[i], endTranslation[i], interp);
+
+  float rotationStart[4];
+  float rotationEnd[4];
+  LoadRotation(startRotation, rotationStart);
+  LoadRotation(endRotation, rotationEnd);
+
+  const float dot = rotationStart[0] * rotationEnd[0] + rotationStart[1] * rotationEnd[1] + rotationStart[2] * rotationEnd[2] +
+                    rotationStart[3] * rotationEnd[3];
+
+  // q and -q are the same rotation, flip the end so we don't go the long way around
+  const float sign = dot < 0.0f ? -1.0f : 1.0f;
+
+  float rotation[4];
+  for (size_t i = 0; i < 4; i++) rotation[i] = Lerp(rotationStart[i], sign * rotationEnd[i], interp);
+
+  StoreBoneRotation(rotation, transform);
+#endif
+}
+
+// evaluate the cubics of a bone's translation and rotation from a keyframe at interp, and normalise the rotation
+static void EvaluateBoneCubic(
+    const float* translationCoefficients, const float* rotationCoefficients, const float interp, vr::VRBoneTransform_t& transform) {
+#if defined(OPENGLOVE_SIMD_SSE)
+  const __m128 t = _mm_set1_ps(interp);
+
+  _mm_storeu_ps(transform.position.v, EvaluateCubic(translationCoefficients, t));
+  StoreBoneRotation(EvaluateCubic(rotationCoefficients, t), transform);
+#elif defined(OPENGLOVE_SIMD_NEON)
+  vst1q_f32(transform.position.v, EvaluateCubic(translationCoefficients, interp));
+  StoreBoneRotation(EvaluateCubic(rotationCoefficients, interp), transform);
+#else
+  EvaluateCubic(translationCoefficients, interp, transform.position.v);
+
+  float rotation[4];
+  EvaluateCubic(rotationCoefficients, interp, rotation);
+
+  StoreBoneRotation(rotation, transform);
+#endif
+}
+
+// where the keyframe of a bone is in a set of linear keyframes, relative to the first. Rotations, quantized or not, and translations are laid out
+// the same way, so one offset serves all of them
+static size_t GetLinearKeyframeOffset(const size_t keyframe, const size_t bone) {
+  static_assert(c_keyframeRotationStride == c_keyframeTranslationStride);
+
+  return (keyframe * c_animationBoneCount + bone) * c_keyframeRotationStride;
+}
+
+// interpolate the listed bones between their keyframes, reading rotations with GetRotation. controllerTransforms is nullptr unless the model
+// has a with-controller range to evaluate into it
+template <typename RotationComponent, const RotationComponent* (AnimationModel::*GetRotation)(size_t, size_t, size_t) const>
+static void InterpolateKeyframes(
+    const AnimationModel& model,
+    const std::span<const size_t> bones,
+    const size_t set,
+    const size_t controllerSet,
+    const KeyframeInterval* intervals,
+    vr::VRBoneTransform_t* transforms,
+    vr::VRBoneTransform_t* controllerTransforms) {
+  const float* translations = model.GetKeyframeTranslation(set, 0, 0);
+  const RotationComponent* rotations = (model.*GetRotation)(set, 0, 0);
+  const float* controllerTranslations = controllerTransforms != nullptr ? model.GetKeyframeTranslation(controllerSet, 0, 0) : nullptr;
+  const RotationComponent* controllerRotations = controllerTransforms != nullptr ? (model.*GetRotation)(controllerSet, 0, 0) : nullptr;
+
+  for (const size_t bone : bones) {
+    const KeyframeInterval& interval = intervals[bone];
+    const size_t lower = GetLinearKeyframeOffset(interval.lowerIndex, bone);
+    const size_t upper = GetLinearKeyframeOffset(interval.upperIndex, bone);
+
+    InterpolateBoneTransform(
+        translations + lower, translations + upper, rotations + lower, rotations + upper, interval.interp, transforms[bone]);
+
+    // same keyframes and interval, from the with-controller keyframes
+    if (controllerTransforms != nullptr) {
+      InterpolateBoneTransform(
+          controllerTranslations + lower,
+          controllerTranslations + upper,
+          controllerRotations + lower,
+          controllerRotations + upper,
+          interval.interp,
+          controllerTransforms[bone]);
     }
   }
 }
 
-Transform GLTFModelManager::GetTransformByBoneIndex(const HandSkeletonBone& boneIndex) const {
-  return initialTransforms_[static_cast<size_t>(boneIndex)];
+void AnimationModel::GetTransforms(
+    const KeyframeInterval* intervals, const bool rightHand, vr::VRBoneTransform_t* transforms, vr::VRBoneTransform_t* controllerTransforms) const {
+  GetTransforms(c_animationBones, intervals, rightHand, transforms, controllerTransforms);
 }
 
-AnimationData GLTFModelManager::GetAnimationDataByBoneIndex(const HandSkeletonBone& boneIndex, const float f) const {
-  const size_t lowerKeyframeIndex = std::upper_bound(keyframeTimes_.begin(), keyframeTimes_.end(), f) - keyframeTimes_.begin() - 1;
-  const size_t upperKeyframeIndex = lowerKeyframeIndex < keyframeTimes_.size() - 1 ? lowerKeyframeIndex + 1 : lowerKeyframeIndex;
+void AnimationModel::GetTransforms(
+    const std::span<const size_t> bones,
+    const KeyframeInterval* intervals,
+    const bool rightHand,
+    vr::VRBoneTransform_t* transforms,
+    vr::VRBoneTransform_t* controllerTransforms) const {
+  // the left hand's keyframes are already mirrored, so both hands only differ in where they're read from
+  const size_t set = GetKeyframeSet(AnimationRange::WithoutController, rightHand);
+  const size_t controllerSet = GetKeyframeSet(AnimationRange::WithController, rightHand);
+  const bool hasControllerRange = controllerTransforms != nullptr && rangeCount > 1;
 
-  AnimationData result;
-  result.startTransform = keyframeTransforms_[static_cast<size_t>(boneIndex)][lowerKeyframeIndex];
-  result.startTime = keyframeTimes_[lowerKeyframeIndex];
-  result.endTransform = keyframeTransforms_[static_cast<size_t>(boneIndex)][upperKeyframeIndex];
-  result.endTime = keyframeTimes_[upperKeyframeIndex];
+  if (coefficientCount == c_hermiteCoefficientCount) {
+    for (const size_t bone : bones) {
+      const KeyframeInterval& interval = intervals[bone];
 
-  return result;
-}
\ No newline at end of file
+      // the cubic from the lower keyframe covers the whole interval, and the last keyframe's holds it where it is
+      EvaluateBoneCubic(
+          GetKeyframeTranslation(set, interval.lowerIndex, bone),
+          GetKeyframeRotation(set, interval.lowerIndex, bone),
+          interval.interp,
+          transforms[bone]);
+
+      if (hasControllerRange) {
+        EvaluateBoneCubic(
+            GetKeyframeTranslation(controllerSet, interval.lowerIndex, bone),
+            GetKeyframeRotation(controllerSet, interval.lowerIndex, bone),
+            interval.interp,
+            controllerTransforms[bone]);
+      }
+    }
+  } else {
+    vr::VRBoneTransform_t* controllerRangeTransforms = hasControllerRange ? controllerTransforms : nullptr;
+
+    if (!quantizedRotations.empty()) {
+      InterpolateKeyframes<int16_t, &AnimationModel::GetQuantizedKeyframeRotation>(
+          *this, bones, set, controllerSet, intervals, transforms, controllerRangeTransforms);
+    } else {
+      InterpolateKeyframes<float, &AnimationModel::GetKeyframeRotation>(
+          *this, bones, set, controllerSet, intervals, transforms, controllerRangeTransforms);
+    }
+  }
+
+  if (controllerTransforms != nullptr && !hasControllerRange) {
+    for (const size_t bone : bones) controllerTransforms[bone] = transforms[bone];
+  }
+}
+
+const Transform& AnimationModel::GetInitialTransform(const size_t bone, const bool rightHand) const {
+  return initialTransforms[GetHandIndex(rightHand) * c_animationBoneCount + bone];
+}
+
+size_t AnimationModel::GetMemoryUsage() const {
+  return sizeof(AnimationModel) + initialTransforms.size() * sizeof(Transform) + keyframeTimes.size_bytes() + keyframeData.size_bytes() +
+         quantizedRotations.size_bytes();
+}
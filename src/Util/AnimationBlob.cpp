@@ -0,0 +1,312 @@
+#include "Util/AnimationBlob.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "DriverLog.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char c_animationBlobMagic[4] = {'O', 'G', 'A', 'B'};
+
+// floats per bone in the initial transforms section, a wxyz rotation followed by an xyz1 translation
+static const size_t c_animationBlobTransformStride = 8;
+
+// both hands are stored, so the left hand is mapped already mirrored like the rest of the animation
+static const size_t c_animationBlobTransformCount = c_animationBoneCount * c_animationHandCount;
+
+// all offsets and sizes are in bytes from the start of the file. The checksum covers everything after the header, and the source size and
+// hash identify the model the animation was converted from. The source's modification time (in ticks of std::filesystem::file_time_type)
+// lets the driver skip hashing it while it's untouched since then
+struct AnimationBlobHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t boneCount;
+  uint32_t keyframeCount;
+  uint64_t fileSize;
+  uint64_t checksum;
+  uint64_t sourceSize;
+  uint64_t sourceHash;
+  int64_t sourceWriteTime;
+  uint64_t initialTransformsOffset;
+  uint64_t keyframeTimesOffset;
+  uint64_t keyframeDataOffset;
+  uint32_t rangeCount;
+  uint32_t coefficientCount;
+  uint64_t quantizedRotationsOffset;
+  uint64_t quantizedRotationsSize;
+};
+
+static_assert(sizeof(AnimationBlobHeader) == 104, "animation blob header layout changed, bump c_animationBlobVersion");
+
+// 64 bit FNV-1a, enough to catch a truncated or corrupt file, or a model that has been changed since it was converted
+static uint64_t HashBytes(const unsigned char* data, const size_t size) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 0x100000001b3ull;
+  }
+
+  return hash;
+}
+
+static size_t AlignOffset(const size_t offset) {
+  return (offset + c_animationBlobAlignment - 1) / c_animationBlobAlignment * c_animationBlobAlignment;
+}
+
+static bool ReadFileBytes(const std::string& fileName, std::vector<unsigned char>& result) {
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file) return false;
+
+  result.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+  return !file.bad();
+}
+
+// a read only view of a whole file, which stays mapped for as long as the animation pointing into it is alive
+class FileMapping {
+ public:
+  explicit FileMapping(const std::string& fileName) {
+#if defined(_WIN32)
+    file_ = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart == 0) return;
+
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ == nullptr) return;
+
+    data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ != nullptr) size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+    file_ = open(fileName.c_str(), O_RDONLY);
+    if (file_ < 0) return;
+
+    struct stat fileStat;
+    if (fstat(file_, &fileStat) != 0 || fileStat.st_size == 0) return;
+
+    void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file_, 0);
+    if (data == MAP_FAILED) return;
+
+    data_ = static_cast<const unsigned char*>(data);
+    size_ = static_cast<size_t>(fileStat.st_size);
+#endif
+  }
+
+  ~FileMapping() {
+#if defined(_WIN32)
+    if (data_ != nullptr) UnmapViewOfFile(data_);
+    if (mapping_ != nullptr) CloseHandle(mapping_);
+    if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+    if (data_ != nullptr) munmap(const_cast<unsigned char*>(data_), size_);
+    if (file_ >= 0) close(file_);
+#endif
+  }
+
+  FileMapping(const FileMapping&) = delete;
+  FileMapping& operator=(const FileMapping&) = delete;
+
+  const unsigned char* GetData() const {
+    return data_;
+  }
+  size_t GetSize() const {
+    return size_;
+  }
+
+ private:
+#if defined(_WIN32)
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+#else
+  int file_ = -1;
+#endif
+
+  const unsigned char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+std::string GetAnimationBlobPath(const std::string& modelFileName) {
+  const size_t extension = modelFileName.find_last_of('.');
+  const size_t directory = modelFileName.find_last_of("\\/");
+
+  if (extension == std::string::npos || (directory != std::string::npos && extension < directory)) return modelFileName + c_animationBlobExtension;
+
+  return modelFileName.substr(0, extension) + c_animationBlobExtension;
+}
+
+bool WriteAnimationBlob(const std::string& fileName, const AnimationModel& model, const std::string& sourceFileName) {
+  if (model.initialTransforms.size() != c_animationBlobTransformCount || model.baked) {
+    DriverLog("Only keyframed animations of %zu bones can be precompiled", c_animationBoneCount);
+    return false;
+  }
+
+  std::vector<unsigned char> source;
+  std::error_code error;
+  const std::filesystem::file_time_type sourceWriteTime = std::filesystem::last_write_time(sourceFileName, error);
+  if (error || !ReadFileBytes(sourceFileName, source)) {
+    DriverLog("Failed to read animation source %s", sourceFileName.c_str());
+    return false;
+  }
+
+  const size_t keyframeCount = model.keyframeTimes.size();
+
+  AnimationBlobHeader header{};
+  std::memcpy(header.magic, c_animationBlobMagic, sizeof(header.magic));
+  header.version = c_animationBlobVersion;
+  header.boneCount = static_cast<uint32_t>(c_animationBoneCount);
+  header.keyframeCount = static_cast<uint32_t>(keyframeCount);
+  header.rangeCount = static_cast<uint32_t>(model.rangeCount);
+  header.coefficientCount = static_cast<uint32_t>(model.coefficientCount);
+  header.sourceSize = source.size();
+  header.sourceHash = HashBytes(source.data(), source.size());
+  header.sourceWriteTime = static_cast<int64_t>(sourceWriteTime.time_since_epoch().count());
+  header.initialTransformsOffset = AlignOffset(sizeof(AnimationBlobHeader));
+  header.keyframeTimesOffset =
+      AlignOffset(header.initialTransformsOffset + c_animationBlobTransformCount * c_animationBlobTransformStride * sizeof(float));
+  header.keyframeDataOffset = AlignOffset(header.keyframeTimesOffset + model.keyframeTimes.size_bytes());
+  header.fileSize = header.keyframeDataOffset + model.keyframeData.size_bytes();
+
+  // quantized rotations get a section after the keyframes, which only have the translations
+  if (!model.quantizedRotations.empty()) {
+    header.quantizedRotationsOffset = AlignOffset(header.fileSize);
+    header.quantizedRotationsSize = model.quantizedRotations.size_bytes();
+    header.fileSize = header.quantizedRotationsOffset + header.quantizedRotationsSize;
+  }
+
+  std::vector<unsigned char> blob(header.fileSize, 0);
+
+  float* initialTransforms = reinterpret_cast<float*>(&blob[header.initialTransformsOffset]);
+  for (size_t bone = 0; bone < c_animationBlobTransformCount; bone++) {
+    const Transform& transform = model.initialTransforms[bone];
+    float* destination = &initialTransforms[bone * c_animationBlobTransformStride];
+
+    std::copy(transform.rotation.begin(), transform.rotation.end(), destination);
+    std::copy(transform.translation.begin(), transform.translation.end(), destination + transform.rotation.size());
+    destination[c_animationBlobTransformStride - 1] = 1.0f;
+  }
+
+  std::memcpy(&blob[header.keyframeTimesOffset], model.keyframeTimes.data(), model.keyframeTimes.size_bytes());
+  std::memcpy(&blob[header.keyframeDataOffset], model.keyframeData.data(), model.keyframeData.size_bytes());
+  if (!model.quantizedRotations.empty())
+    std::memcpy(&blob[header.quantizedRotationsOffset], model.quantizedRotations.data(), model.quantizedRotations.size_bytes());
+
+  header.checksum = HashBytes(blob.data() + sizeof(AnimationBlobHeader), blob.size() - sizeof(AnimationBlobHeader));
+  std::memcpy(blob.data(), &header, sizeof(AnimationBlobHeader));
+
+  std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+  file.close();
+
+  if (!file) {
+    DriverLog("Failed to write precompiled animation %s", fileName.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+// whether the model is still the one the animation was converted from. Only read and hashed if its size matches and it was modified since,
+// as copying the driver can change when the model was written without changing the model
+static bool IsSourceUnchanged(const AnimationBlobHeader& header, const std::string& sourceFileName) {
+  std::error_code error;
+  const uintmax_t sourceSize = std::filesystem::file_size(sourceFileName, error);
+  if (error || sourceSize != header.sourceSize) return false;
+
+  const std::filesystem::file_time_type sourceWriteTime = std::filesystem::last_write_time(sourceFileName, error);
+  if (!error && static_cast<int64_t>(sourceWriteTime.time_since_epoch().count()) == header.sourceWriteTime) return true;
+
+  std::vector<unsigned char> source;
+  return ReadFileBytes(sourceFileName, source) && source.size() == header.sourceSize && HashBytes(source.data(), source.size()) == header.sourceHash;
+}
+
+std::shared_ptr<AnimationModel> LoadAnimationBlob(const std::string& fileName, const std::string& sourceFileName) {
+  auto mapping = std::make_shared<const FileMapping>(fileName);
+
+  // not having a precompiled animation is fine, the model gets parsed instead
+  if (mapping->GetData() == nullptr) return nullptr;
+
+  const unsigned char* data = mapping->GetData();
+  const size_t size = mapping->GetSize();
+
+  if (size < sizeof(AnimationBlobHeader)) {
+    DriverLog("Precompiled animation %s is truncated, parsing the model instead", fileName.c_str());
+    return nullptr;
+  }
+
+  AnimationBlobHeader header;
+  std::memcpy(&header, data, sizeof(AnimationBlobHeader));
+
+  if (std::memcmp(header.magic, c_animationBlobMagic, sizeof(header.magic)) != 0 || header.version != c_animationBlobVersion ||
+      header.boneCount != c_animationBoneCount) {
+    DriverLog("Precompiled animation %s is from another version, parsing the model instead", fileName.c_str());
+    return nullptr;
+  }
+
+  const size_t keyframeCount = header.keyframeCount;
+  const size_t rangeCount = header.rangeCount;
+  const size_t coefficientCount = header.coefficientCount;
+  const bool quantizedRotations = header.quantizedRotationsSize != 0;
+  const size_t keyframeDataSize =
+      AnimationModel::GetKeyframeDataSize(keyframeCount, rangeCount, coefficientCount, quantizedRotations) * sizeof(float);
+  const size_t quantizedRotationsSize = quantizedRotations ? AnimationModel::GetQuantizedRotationsSize(keyframeCount, rangeCount) : 0;
+
+  const bool validLayout = keyframeCount >= 1 && rangeCount >= 1 && rangeCount <= c_animationRangeCount &&
+                           (coefficientCount == 1 || coefficientCount == c_hermiteCoefficientCount) &&
+                           (!quantizedRotations || coefficientCount == 1) && header.fileSize == size &&
+                           header.initialTransformsOffset % c_animationBlobAlignment == 0 &&
+                           header.keyframeTimesOffset % c_animationBlobAlignment == 0 && header.keyframeDataOffset % c_animationBlobAlignment == 0 &&
+                           header.initialTransformsOffset >= sizeof(AnimationBlobHeader) &&
+                           header.initialTransformsOffset + c_animationBlobTransformCount * c_animationBlobTransformStride * sizeof(float) <= size &&
+                           header.keyframeTimesOffset + keyframeCount * sizeof(float) <= size &&
+                           header.keyframeDataOffset + keyframeDataSize <= size && header.quantizedRotationsOffset % c_animationBlobAlignment == 0 &&
+                           header.quantizedRotationsSize == quantizedRotationsSize * sizeof(int16_t) &&
+                           header.quantizedRotationsOffset + header.quantizedRotationsSize <= size;
+
+  if (!validLayout || HashBytes(data + sizeof(AnimationBlobHeader), size - sizeof(AnimationBlobHeader)) != header.checksum) {
+    DriverLog("Precompiled animation %s is corrupt, parsing the model instead", fileName.c_str());
+    return nullptr;
+  }
+
+  if (!IsSourceUnchanged(header, sourceFileName)) {
+    DriverLog("Precompiled animation %s is out of date with %s, parsing the model instead", fileName.c_str(), sourceFileName.c_str());
+    return nullptr;
+  }
+
+  auto result = std::make_shared<AnimationModel>();
+
+  const float* initialTransforms = reinterpret_cast<const float*>(data + header.initialTransformsOffset);
+  result->initialTransforms = std::vector<Transform>(c_animationBlobTransformCount);
+  for (size_t bone = 0; bone < c_animationBlobTransformCount; bone++) {
+    Transform& transform = result->initialTransforms[bone];
+    const float* stored = &initialTransforms[bone * c_animationBlobTransformStride];
+
+    std::copy(stored, stored + transform.rotation.size(), transform.rotation.begin());
+    std::copy(stored + transform.rotation.size(), stored + transform.rotation.size() + transform.translation.size(), transform.translation.begin());
+  }
+
+  result->keyframeTimes = std::span<const float>(reinterpret_cast<const float*>(data + header.keyframeTimesOffset), keyframeCount);
+  result->keyframeData = std::span<const float>(
+      reinterpret_cast<const float*>(data + header.keyframeDataOffset),
+      AnimationModel::GetKeyframeDataSize(keyframeCount, rangeCount, coefficientCount, quantizedRotations));
+  if (quantizedRotations)
+    result->quantizedRotations =
+        std::span<const int16_t>(reinterpret_cast<const int16_t*>(data + header.quantizedRotationsOffset), quantizedRotationsSize);
+  result->rangeCount = rangeCount;
+  result->coefficientCount = coefficientCount;
+  result->storage = std::move(mapping);
+
+  return result;
+}
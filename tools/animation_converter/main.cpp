@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+
+#include "DriverLog.h"
+#include "Util/AnimLoader.h"
+#include "Util/AnimationBlob.h"
+
+// the loaders report through the driver log, which goes to the console here
+void DriverLog(const char* pchFormat, ...) {
+  va_list args;
+  va_start(args, pchFormat);
+  vprintf(pchFormat, args);
+  va_end(args);
+
+  printf("\n");
+}
+
+void DebugDriverLog(const char* pchFormat, ...) {}
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "Usage: %s <model.glb> [output%s]\n", argv[0], c_animationBlobExtension);
+    return 1;
+  }
+
+  const std::string modelFileName = argv[1];
+  const std::string blobFileName = argc == 3 ? argv[2] : GetAnimationBlobPath(modelFileName);
+
+  const std::shared_ptr<AnimationModel> model = LoadGLTFAnimationModel(modelFileName);
+  if (model == nullptr) {
+    fprintf(stderr, "Failed to load animation from %s\n", modelFileName.c_str());
+    return 1;
+  }
+
+  if (!WriteAnimationBlob(blobFileName, *model, modelFileName)) return 1;
+
+  // read it back the way the driver will, so a bad file fails the build rather than silently falling back at runtime
+  const std::shared_ptr<AnimationModel> written = LoadAnimationBlob(blobFileName, modelFileName);
+  if (written == nullptr || written->rangeCount != model->rangeCount || !std::ranges::equal(written->keyframeTimes, model->keyframeTimes) ||
+      !std::ranges::equal(written->keyframeData, model->keyframeData) ||
+      !std::ranges::equal(written->quantizedRotations, model->quantizedRotations)) {
+    fprintf(stderr, "Precompiled animation %s doesn't match %s\n", blobFileName.c_str(), modelFileName.c_str());
+    return 1;
+  }
+
+  printf(
+      "Wrote %zu keyframes for %zu motion ranges from %s to %s\n",
+      model->keyframeTimes.size(),
+      model->rangeCount,
+      modelFileName.c_str(),
+      blobFileName.c_str());
+
+  return 0;
+}
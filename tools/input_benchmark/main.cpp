@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "InputFilter.h"
+#include "InputPredictor.h"
+#include "Util/Simd.h"
+
+static const int c_defaultSeconds = 60;
+static const int c_repetitions = 20;
+
+// the synthetic glove samples at this rate, and sends its samples in batches of this many, like a v3 named pipe client
+static const double c_sampleRate = 1000.0;
+static const int c_defaultBatchSize = 8;
+
+// resolution of the glove's sensors, and how many steps of noise they read either side of the true value
+static const double c_sensorSteps = 1023.0;
+static const double c_sensorNoise = 3.0;
+
+// largest difference in any channel from the double precision filter that still passes
+static const double c_filterTolerance = 1e-4;
+
+// the filter settings the driver ships with
+static const VRFilterConfiguration c_filterConfiguration = {true, 1.0f, 10.0f, 1.0f, 10.0f, 2.0f, 10.0f, 1.0f};
+
+// how far ahead of the newest sample the prediction replay shows the fingers
+static const double c_replayLeads[] = {0.0, 0.01, 0.02, 0.03, 0.05};
+
+static const double c_pi = 3.14159265358979323846;
+
+// xorshift, so that the input is the same on every platform and standard library
+static double NextRandom(uint32_t& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+
+  return state / 4294967296.0;
+}
+
+// one finger closing or opening with a minimum jerk profile, or resting where it is when from and to are the same
+struct Movement {
+  double start;
+  double duration;
+  double from;
+  double to;
+};
+
+// grasps of a quarter to most of a second with rests in between, for each finger
+static std::vector<std::vector<Movement>> GetGraspMovements(const double seconds, uint32_t& state) {
+  std::vector<std::vector<Movement>> result(5);
+
+  for (auto& finger : result) {
+    double time = 0.0;
+    double curl = 0.0;
+
+    while (time < seconds + 1.0) {
+      const double rest = 0.1 + 0.6 * NextRandom(state);
+      finger.push_back({time, rest, curl, curl});
+      time += rest;
+
+      const double duration = 0.25 + 0.55 * NextRandom(state);
+      const double target = curl < 0.5 ? 0.5 + 0.5 * NextRandom(state) : 0.3 * NextRandom(state);
+      finger.push_back({time, duration, curl, target});
+      time += duration;
+      curl = target;
+    }
+  }
+
+  return result;
+}
+
+static double GetCurl(const std::vector<Movement>& movements, const double time) {
+  const auto next = std::upper_bound(
+      movements.begin(), movements.end(), time, [](const double t, const Movement& movement) { return t < movement.start; });
+  const Movement& movement = *(next == movements.begin() ? next : next - 1);
+
+  const double s = std::clamp((time - movement.start) / movement.duration, 0.0, 1.0);
+  return movement.from + (movement.to - movement.from) * s * s * s * (10.0 - 15.0 * s + 6.0 * s * s);
+}
+
+// the hand without any sensor noise
+static void GetTrueInput(const std::vector<std::vector<Movement>>& movements, const double time, VRInputData& result) {
+  for (size_t finger = 0; finger < result.flexion.size(); finger++) {
+    const double curl = GetCurl(movements[finger], time);
+
+    // joints further along the finger curl a little less
+    for (size_t joint = 0; joint < result.flexion[finger].size(); joint++)
+      result.flexion[finger][joint] = static_cast<float>(curl * (1.0 - 0.1 * joint));
+
+    // the thumb's sensor doesn't report splay, so its channel stays out of range
+    result.splay[finger] = finger == 0 ? -2.0f : static_cast<float>(0.4 * std::sin(0.7 * time + finger) * (1.0 - curl));
+  }
+
+  result.joyX = static_cast<float>(0.9 * std::sin(1.3 * time));
+  result.joyY = static_cast<float>(0.9 * std::sin(0.4 * time) * std::cos(2.2 * time));
+}
+
+// what the glove reads, quantized to its sensors' steps with noise on top
+static float Measure(const float value, uint32_t& state) {
+  if (!(std::abs(value) <= 1.0f)) return value;
+
+  const double steps = std::round(value * c_sensorSteps + (NextRandom(state) * 2.0 - 1.0) * c_sensorNoise);
+  return static_cast<float>(std::clamp(steps / c_sensorSteps, -1.0, 1.0));
+}
+
+// a glove's samples as the named pipe hands them on, each stamped with when it was taken
+static std::vector<VRInputData> GetSamples(const std::vector<std::vector<Movement>>& movements, const int sampleCount, const int batchSize) {
+  // zero is taken to mean no timestamp, so the samples start a second into the clock
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::time_point{} + std::chrono::seconds(1);
+
+  std::vector<VRInputData> result(sampleCount);
+  uint32_t randomState = 0x9e3779b9u;
+  for (int i = 0; i < sampleCount; i++) {
+    const double time = i / c_sampleRate;
+
+    VRInputData& sample = result[i];
+    GetTrueInput(movements, time, sample);
+
+    for (auto& finger : sample.flexion)
+      for (float& joint : finger) joint = Measure(joint, randomState);
+    for (float& splay : sample.splay) splay = Measure(splay, randomState);
+    sample.joyX = Measure(sample.joyX, randomState);
+    sample.joyY = Measure(sample.joyY, randomState);
+
+    sample.isLatestSample = (i + 1) % batchSize == 0 || i == sampleCount - 1;
+    sample.timestamp = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(time));
+  }
+
+  return result;
+}
+
+// every analog channel of a sample, in the order the filter takes them
+static std::array<float, c_inputFilterChannelCount> GetChannels(const VRInputData& data) {
+  std::array<float, c_inputFilterChannelCount> result;
+
+  size_t channel = 0;
+  for (const auto& finger : data.flexion)
+    for (const float joint : finger) result[channel++] = joint;
+  for (const float splay : data.splay) result[channel++] = splay;
+  result[channel++] = data.joyX;
+  result[channel] = data.joyY;
+
+  return result;
+}
+
+// the One Euro filter in double precision, one channel at a time, with the time between samples taken straight from their timestamps
+class ReferenceFilter {
+ public:
+  explicit ReferenceFilter(const VRFilterConfiguration& configuration) : configuration_(configuration), value_(), derivative_(), lastTime_(-1.0) {
+    value_.fill(-2.0);
+  }
+
+  void Filter(const double time, std::array<double, c_inputFilterChannelCount>& channels) {
+    const double interval = lastTime_ >= 0.0 ? time - lastTime_ : 0.01;
+    lastTime_ = time;
+
+    for (size_t i = 0; i < channels.size(); i++) {
+      const double value = channels[i];
+      const double previous = value_[i];
+
+      if (!(std::abs(value) <= 1.0 && std::abs(previous) <= 1.0)) {
+        value_[i] = value;
+        derivative_[i] = 0.0;
+        continue;
+      }
+
+      const double derivativeAlpha = GetAlpha(configuration_.derivativeCutoff, interval);
+      derivative_[i] += derivativeAlpha * ((value - previous) / interval - derivative_[i]);
+
+      const double cutoff = GetMinCutoff(i) + GetBeta(i) * std::abs(derivative_[i]);
+      channels[i] = previous + GetAlpha(cutoff, interval) * (value - previous);
+      value_[i] = channels[i];
+    }
+  }
+
+ private:
+  static double GetAlpha(const double cutoff, const double interval) {
+    const double tau = 1.0 / (2.0 * c_pi * cutoff);
+    return 1.0 / (1.0 + tau / interval);
+  }
+
+  double GetMinCutoff(const size_t channel) const {
+    return channel < 20 ? configuration_.flexionMinCutoff : channel < 25 ? configuration_.splayMinCutoff : configuration_.joystickMinCutoff;
+  }
+
+  double GetBeta(const size_t channel) const {
+    return channel < 20 ? configuration_.flexionBeta : channel < 25 ? configuration_.splayBeta : configuration_.joystickBeta;
+  }
+
+  VRFilterConfiguration configuration_;
+  std::array<double, c_inputFilterChannelCount> value_;
+  std::array<double, c_inputFilterChannelCount> derivative_;
+  double lastTime_;
+};
+
+// check InputFilter against the double precision filter over every sample
+static bool CheckFilter(const std::vector<VRInputData>& samples) {
+  InputFilter filter(c_filterConfiguration);
+  ReferenceFilter reference(c_filterConfiguration);
+
+  double error = 0.0;
+  for (size_t i = 0; i < samples.size(); i++) {
+    VRInputData filtered = samples[i];
+    filter.Filter(filtered);
+
+    const std::array<float, c_inputFilterChannelCount> measured = GetChannels(samples[i]);
+    std::array<double, c_inputFilterChannelCount> expected;
+    std::copy(measured.begin(), measured.end(), expected.begin());
+    reference.Filter(i / c_sampleRate, expected);
+
+    const std::array<float, c_inputFilterChannelCount> actual = GetChannels(filtered);
+    for (size_t channel = 0; channel < actual.size(); channel++) {
+      const double channelError = std::abs(actual[channel] - expected[channel]);
+
+      // NaN fails too
+      if (!(channelError <= error)) error = channelError;
+    }
+  }
+
+#if defined(OPENGLOVE_SIMD_SSE)
+  const char* kernel = "SSE";
+#elif defined(OPENGLOVE_SIMD_NEON)
+  const char* kernel = "NEON";
+#else
+  const char* kernel = "scalar";
+#endif
+
+  printf("Filtered samples (%s): %zu checked, max error %g (tolerance %g)\n", kernel, samples.size(), error, c_filterTolerance);
+  if (!(error <= c_filterTolerance)) {
+    printf("InputFilter differs from the double precision filter by %g\n", error);
+    return false;
+  }
+
+  return true;
+}
+
+static void TimeFilter(const std::vector<VRInputData>& samples) {
+  std::vector<double> nsPerSample;
+  VRInputData result;
+
+  for (int repetition = 0; repetition <= c_repetitions; repetition++) {
+    InputFilter filter(c_filterConfiguration);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const VRInputData& sample : samples) {
+      result = sample;
+      filter.Filter(result);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    // the first time through warms the cache
+    if (repetition > 0) nsPerSample.push_back(std::chrono::duration<double, std::nano>(end - start).count() / samples.size());
+  }
+
+  // keep the result alive, so the work that produced it can't be optimised away
+  volatile float sink = result.flexion[4][3];
+  (void)sink;
+
+  std::sort(nsPerSample.begin(), nsPerSample.end());
+
+  printf("\n%-24s %14s %14s\n", "filter", "min ns/sample", "med ns/sample");
+  printf("%-24s %14.2f %14.2f\n", "InputFilter", nsPerSample.front(), nsPerSample[nsPerSample.size() / 2]);
+}
+
+// the skeleton settings the driver ships with, predicting lead seconds ahead
+static VRSkeletonConfiguration GetSkeletonConfiguration(const double lead) {
+  return {0, 100, static_cast<float>(lead), 0.85f, 0.5f, 0.0f, false};
+}
+
+// root mean square curl error of each way of showing the fingers, against where they really are
+struct PredictionError {
+  double predictedSum = 0.0;
+  double batchStampedSum = 0.0;
+  double unpredictedSum = 0.0;
+  size_t count = 0;
+};
+
+// replay the glove through the filter and predictor as the driver does, and compare the fingers predicted lead ahead of each batch's newest
+// sample with where they were then. The batch stamped column gives every sample of a batch the newest sample's time, as the pipe used to, so
+// the predictor takes the whole batch period as the time between samples
+static void ReplayPrediction(const std::vector<std::vector<Movement>>& movements, const std::vector<VRInputData>& samples) {
+  std::vector<VRInputData> batchStampedSamples = samples;
+  for (size_t i = batchStampedSamples.size(); i-- > 0;) {
+    if (!batchStampedSamples[i].isLatestSample) batchStampedSamples[i].timestamp = batchStampedSamples[i + 1].timestamp;
+  }
+
+  const std::chrono::steady_clock::time_point start = samples.front().timestamp;
+
+  printf(
+      "\nPrediction replay: %zu samples at %.0f Hz, RMS curl error against the true curl lead ahead of each batch\n", samples.size(), c_sampleRate);
+  printf("%-10s %14s %14s %14s\n", "lead ms", "predicted", "batch stamped", "unpredicted");
+
+  for (const double lead : c_replayLeads) {
+    const VRSkeletonConfiguration configuration = GetSkeletonConfiguration(lead);
+    const std::chrono::steady_clock::duration leadDuration =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(lead));
+
+    InputFilter filter(c_filterConfiguration);
+    InputFilter batchStampedFilter(c_filterConfiguration);
+    InputPredictor predictor(configuration);
+    InputPredictor batchStampedPredictor(configuration);
+
+    PredictionError error;
+    for (size_t i = 0; i < samples.size(); i++) {
+      VRInputData filtered = samples[i];
+      filter.Filter(filtered);
+      predictor.Update(filtered);
+
+      VRInputData batchStamped = batchStampedSamples[i];
+      batchStampedFilter.Filter(batchStamped);
+      batchStampedPredictor.Update(batchStamped);
+
+      if (!filtered.isLatestSample) continue;
+
+      VRInputData predicted = filtered;
+      predictor.Predict(predicted, filtered.timestamp + leadDuration);
+      batchStampedPredictor.Predict(batchStamped, filtered.timestamp + leadDuration);
+
+      VRInputData expected;
+      GetTrueInput(movements, std::chrono::duration<double>(filtered.timestamp - start).count() + lead, expected);
+
+      for (size_t finger = 0; finger < expected.flexion.size(); finger++) {
+        for (size_t joint = 0; joint < expected.flexion[finger].size(); joint++) {
+          const double truth = expected.flexion[finger][joint];
+          error.predictedSum += std::pow(predicted.flexion[finger][joint] - truth, 2.0);
+          error.batchStampedSum += std::pow(batchStamped.flexion[finger][joint] - truth, 2.0);
+          error.unpredictedSum += std::pow(filtered.flexion[finger][joint] - truth, 2.0);
+          error.count++;
+        }
+      }
+    }
+
+    printf(
+        "%-10.0f %14.4f %14.4f %14.4f\n",
+        lead * 1e3,
+        std::sqrt(error.predictedSum / error.count),
+        std::sqrt(error.batchStampedSum / error.count),
+        std::sqrt(error.unpredictedSum / error.count));
+  }
+}
+
+static void PrintUsage(const char* program) {
+  fprintf(stderr, "Usage: %s [--seconds <count>] [--batch <samples>] [--skip-timing]\n", program);
+}
+
+int main(int argc, char** argv) {
+  int seconds = c_defaultSeconds;
+  int batchSize = c_defaultBatchSize;
+  bool skipTiming = false;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string argument = argv[i];
+    const bool hasValue = i + 1 < argc;
+
+    if (argument == "--seconds" && hasValue) {
+      seconds = std::max(std::atoi(argv[++i]), 1);
+    } else if (argument == "--batch" && hasValue) {
+      batchSize = std::max(std::atoi(argv[++i]), 1);
+    } else if (argument == "--skip-timing") {
+      skipTiming = true;
+    } else {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  uint32_t randomState = 0x2545f491u;
+  const std::vector<std::vector<Movement>> movements = GetGraspMovements(seconds, randomState);
+  const std::vector<VRInputData> samples = GetSamples(movements, static_cast<int>(seconds * c_sampleRate), batchSize);
+
+  const bool passed = CheckFilter(samples);
+  ReplayPrediction(movements, samples);
+
+  if (skipTiming) return passed ? 0 : 1;
+
+  TimeFilter(samples);
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,983 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DriverLog.h"
+#include "PoseComposer.h"
+#include "PosePublisher.h"
+#include "Util/Quaternion.h"
+#include "Util/SimdMath.h"
+
+static const int c_defaultPoses = 4096;
+static const int c_repetitions = 20;
+
+// largest difference in any component from the double precision rotation that still passes
+static const double c_rotationTolerance = 2e-6;
+
+// samples the pose math is compared with its double precision reference at, for each set of rotations, and the largest difference in any
+// component that still passes, relative to the size of the vector where that's over 1
+static const int c_mathSamples = 100000;
+static const double c_mathTolerance = 1e-6;
+
+// largest difference in any part of a composed pose from the double precision pose that still passes, relative to its size where that's over 1
+static const double c_poseTolerance = 1e-5;
+
+// rate the tracked controller is sampled at, like the driver's pose thread
+static const double c_controllerSampleRate = 500.0;
+
+// how old the controller's pose is when the glove's is published, and how long after that the runtime shows it, for the prediction replay.
+// Together they're a whole number of samples, so the pose that's shown can be compared with the one the controller had then
+static const double c_replayPoseAge = 0.001;
+static const double c_replayDisplayLatency = 0.011;
+
+// prediction times the replay tries, either side of the default pose_time_offset
+static const double c_replayPredictionTimes[] = {-0.01, 0.0, 0.01};
+
+// how far (in metres) a controller held still wanders between updates with the tracking's noise, and the constant velocities a tracker's
+// filter might leave it reporting
+static const double c_stillNoise = 1e-4;
+static const float c_stillDriftVelocity = 0.002f;
+static const float c_stillDriftAngularVelocity = 0.01f;
+
+// time between polls in the update detection check, like the publisher's, how much later than the poll notes a fetch the runtime takes the
+// time it predicts from (up to), and the share of a still controller's updates that can go unseen, as its noise can happen to stay within
+// the tolerance on every axis
+static const double c_detectionPollInterval = 100e-6;
+static const double c_detectionFetchDelay = 20e-6;
+static const double c_maxMissedStillUpdates = 0.01;
+
+// the publisher's thread logs through the driver log, which goes to the console here
+void DriverLog(const char* pchFormat, ...) {
+  va_list args;
+  va_start(args, pchFormat);
+  vfprintf(stderr, pchFormat, args);
+  va_end(args);
+
+  fprintf(stderr, "\n");
+}
+
+void DebugDriverLog(const char* pchFormat, ...) {}
+
+enum class RotationSet {
+  // rotations spread evenly over every orientation
+  Uniform,
+  // within a hundredth of a degree of a half turn, where w is close to 0
+  NearHalfTurn,
+  // within a hundredth of a degree of no rotation, where x, y and z are close to 0
+  NearIdentity,
+  // one controller turning smoothly through every orientation, so each rotation is close to the last like the poses of a tracked device
+  Tracked,
+};
+
+static const RotationSet c_rotationSets[] = {RotationSet::Uniform, RotationSet::NearHalfTurn, RotationSet::NearIdentity, RotationSet::Tracked};
+static const RotationSet c_timedRotationSets[] = {RotationSet::Uniform, RotationSet::Tracked};
+
+static const char* GetRotationSetName(const RotationSet set) {
+  switch (set) {
+    case RotationSet::Uniform:
+      return "uniform";
+    case RotationSet::NearHalfTurn:
+      return "near_half_turn";
+    case RotationSet::NearIdentity:
+      return "near_identity";
+    case RotationSet::Tracked:
+      return "tracked";
+  }
+
+  return "unknown";
+}
+
+// xorshift, so that the poses are the same on every platform and standard library
+static double NextRandom(uint32_t& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+
+  return static_cast<double>(state >> 8) / static_cast<double>(1 << 24);
+}
+
+static vr::HmdQuaternion_t Normalize(const vr::HmdQuaternion_t& q) {
+  const double length = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+
+  return {q.w / length, q.x / length, q.y / length, q.z / length};
+}
+
+static vr::HmdQuaternion_t GetTestRotation(const RotationSet set, const int index, uint32_t& state) {
+  vr::HmdQuaternion_t q;
+
+  if (set == RotationSet::Tracked) {
+    // about 3 degrees a pose, around an axis that wanders over the sphere
+    const double angle = index * 0.05;
+    const double inclination = index * 0.0031;
+    const double azimuth = index * 0.0017;
+    const double sinHalfAngle = std::sin(angle * 0.5);
+
+    q = {
+        std::cos(angle * 0.5),
+        std::sin(inclination) * std::cos(azimuth) * sinHalfAngle,
+        std::sin(inclination) * std::sin(azimuth) * sinHalfAngle,
+        std::cos(inclination) * sinHalfAngle};
+  } else {
+    // a random direction from 4 normally distributed components, by Box-Muller
+    double components[4];
+    for (double& component : components)
+      component = std::sqrt(-2.0 * std::log(1.0 - NextRandom(state))) * std::cos(2.0 * 3.14159265358979323846 * NextRandom(state));
+
+    q = Normalize(vr::HmdQuaternion_t{components[0], components[1], components[2], components[3]});
+  }
+
+  // a hundredth of a degree is sin(0.005 degrees) of the components
+  const double c_nearScale = 8.7e-5;
+
+  switch (set) {
+    case RotationSet::Uniform:
+    case RotationSet::Tracked:
+      break;
+
+    case RotationSet::NearHalfTurn:
+      q.w *= c_nearScale;
+      break;
+
+    case RotationSet::NearIdentity:
+      q.x *= c_nearScale;
+      q.y *= c_nearScale;
+      q.z *= c_nearScale;
+      break;
+  }
+
+  q = Normalize(q);
+  if (q.w < 0.0) q = {-q.w, -q.x, -q.y, -q.z};
+
+  return q;
+}
+
+static void SetRotation(const vr::HmdQuaternion_t& q, vr::HmdMatrix34_t& matrix) {
+  float(&m)[3][4] = matrix.m;
+
+  m[0][0] = static_cast<float>(1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+  m[0][1] = static_cast<float>(2.0 * (q.x * q.y - q.w * q.z));
+  m[0][2] = static_cast<float>(2.0 * (q.x * q.z + q.w * q.y));
+  m[1][0] = static_cast<float>(2.0 * (q.x * q.y + q.w * q.z));
+  m[1][1] = static_cast<float>(1.0 - 2.0 * (q.x * q.x + q.z * q.z));
+  m[1][2] = static_cast<float>(2.0 * (q.y * q.z - q.w * q.x));
+  m[2][0] = static_cast<float>(2.0 * (q.x * q.z - q.w * q.y));
+  m[2][1] = static_cast<float>(2.0 * (q.y * q.z + q.w * q.x));
+  m[2][2] = static_cast<float>(1.0 - 2.0 * (q.x * q.x + q.y * q.y));
+}
+
+// the pose a tracked device would report for rotation q, somewhere in a room
+static vr::TrackedDevicePose_t GetPose(const vr::HmdQuaternion_t& q, uint32_t& state) {
+  vr::TrackedDevicePose_t result{};
+  SetRotation(q, result.mDeviceToAbsoluteTracking);
+
+  for (int row = 0; row < 3; row++) result.mDeviceToAbsoluteTracking.m[row][3] = static_cast<float>(NextRandom(state) * 4.0 - 2.0);
+
+  result.bPoseIsValid = true;
+  result.bDeviceIsConnected = true;
+  result.eTrackingResult = vr::TrackingResult_Running_OK;
+
+  return result;
+}
+
+// the extraction GetRotation used before, with a square root for each component and the signs taken from the antisymmetric part, to compare
+// against
+static Quatf GetRotationFromEveryDiagonal(const vr::HmdMatrix34_t& matrix) {
+  const float(&m)[3][4] = matrix.m;
+
+  return {Float4Set(
+      std::sqrt(std::max(0.0f, 1.0f + m[0][0] + m[1][1] + m[2][2])) * 0.5f,
+      std::copysign(std::sqrt(std::max(0.0f, 1.0f + m[0][0] - m[1][1] - m[2][2])) * 0.5f, m[2][1] - m[1][2]),
+      std::copysign(std::sqrt(std::max(0.0f, 1.0f - m[0][0] + m[1][1] - m[2][2])) * 0.5f, m[0][2] - m[2][0]),
+      std::copysign(std::sqrt(std::max(0.0f, 1.0f - m[0][0] - m[1][1] + m[2][2])) * 0.5f, m[1][0] - m[0][1]))};
+}
+
+// largest difference in any component from the expected rotation, as either sign of a quaternion is the same rotation
+static double GetRotationError(const vr::HmdQuaternion_t& expected, const Quatf actual) {
+  const vr::HmdQuaternion_t q = ToHmdQuaternion(actual);
+
+  const double same = std::max({std::abs(q.w - expected.w), std::abs(q.x - expected.x), std::abs(q.y - expected.y), std::abs(q.z - expected.z)});
+  const double opposite =
+      std::max({std::abs(q.w + expected.w), std::abs(q.x + expected.x), std::abs(q.y + expected.y), std::abs(q.z + expected.z)});
+
+  return std::min(same, opposite);
+}
+
+struct TimingResult {
+  double minNsPerPose;
+  double medianNsPerPose;
+};
+
+template <typename Function>
+static TimingResult Time(const size_t poseCount, Function&& function) {
+  // once through first, so that the poses are in cache like they would be while running
+  function();
+
+  std::vector<double> nsPerPose;
+  for (int repetition = 0; repetition < c_repetitions; repetition++) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+
+    nsPerPose.push_back(std::chrono::duration<double, std::nano>(end - start).count() / poseCount);
+  }
+
+  std::sort(nsPerPose.begin(), nsPerPose.end());
+
+  return {nsPerPose.front(), nsPerPose[nsPerPose.size() / 2]};
+}
+
+// check GetRotation and GetRotations against the rotations each pose was built from
+static bool CheckRotations(const int poseCount) {
+  bool passed = true;
+
+  printf("%-16s %18s %18s %18s\n", "rotations", "every diagonal", "GetRotation", "GetRotations");
+
+  for (const RotationSet set : c_rotationSets) {
+    uint32_t randomState = 0x9e3779b9u;
+
+    std::vector<vr::HmdQuaternion_t> expected(poseCount);
+    std::vector<vr::TrackedDevicePose_t> poses(poseCount);
+    for (int i = 0; i < poseCount; i++) {
+      expected[i] = GetTestRotation(set, i, randomState);
+      poses[i] = GetPose(expected[i], randomState);
+    }
+
+    std::vector<Quatf> single(poseCount);
+    std::vector<Quatf> batched(poseCount);
+    std::vector<Quatf> everyDiagonal(poseCount);
+
+    for (int i = 0; i < poseCount; i++) {
+      single[i] = GetRotation(poses[i].mDeviceToAbsoluteTracking);
+      everyDiagonal[i] = GetRotationFromEveryDiagonal(poses[i].mDeviceToAbsoluteTracking);
+    }
+    GetRotations(poses, batched);
+
+    double everyDiagonalError = 0.0;
+    double singleError = 0.0;
+    int batchedMismatches = 0;
+    for (int i = 0; i < poseCount; i++) {
+      everyDiagonalError = std::max(everyDiagonalError, GetRotationError(expected[i], everyDiagonal[i]));
+      singleError = std::max(singleError, GetRotationError(expected[i], single[i]));
+
+      const vr::HmdQuaternionf_t a = ToHmdQuaternionf(single[i]);
+      const vr::HmdQuaternionf_t b = ToHmdQuaternionf(batched[i]);
+      if (std::memcmp(&a, &b, sizeof(a)) != 0) batchedMismatches++;
+    }
+
+    printf("%-16s %18.3g %18.3g %18s\n", GetRotationSetName(set), everyDiagonalError, singleError, batchedMismatches == 0 ? "identical" : "differs");
+
+    // NaN fails too
+    if (!(singleError <= c_rotationTolerance)) {
+      printf("GetRotation is off by %g on %s rotations (tolerance %g)\n", singleError, GetRotationSetName(set), c_rotationTolerance);
+      passed = false;
+    }
+
+    if (batchedMismatches != 0) {
+      printf("GetRotations differs from GetRotation on %d of %d %s rotations\n", batchedMismatches, poseCount, GetRotationSetName(set));
+      passed = false;
+    }
+  }
+
+  return passed;
+}
+
+static void TimeRotations(const int poseCount) {
+  printf("\n%-16s %-16s %14s %14s\n", "rotations", "extraction", "min ns/pose", "med ns/pose");
+
+  for (const RotationSet set : c_timedRotationSets) {
+    uint32_t randomState = 0x9e3779b9u;
+    std::vector<vr::TrackedDevicePose_t> poses(poseCount);
+    for (int i = 0; i < poseCount; i++) poses[i] = GetPose(GetTestRotation(set, i, randomState), randomState);
+
+    std::vector<Quatf> rotations(poseCount);
+
+    const TimingResult everyDiagonal = Time(poses.size(), [&] {
+      for (size_t i = 0; i < poses.size(); i++) rotations[i] = GetRotationFromEveryDiagonal(poses[i].mDeviceToAbsoluteTracking);
+    });
+    const TimingResult single = Time(poses.size(), [&] {
+      for (size_t i = 0; i < poses.size(); i++) rotations[i] = GetRotation(poses[i].mDeviceToAbsoluteTracking);
+    });
+    const TimingResult batched = Time(poses.size(), [&] { GetRotations(poses, rotations); });
+
+    // keep the rotations alive, so the work that produced them can't be optimised away
+    volatile float sink = ToHmdQuaternionf(rotations.back()).w;
+    (void)sink;
+
+    const char* setName = GetRotationSetName(set);
+    printf("%-16s %-16s %14.2f %14.2f\n", setName, "every diagonal", everyDiagonal.minNsPerPose, everyDiagonal.medianNsPerPose);
+    printf("%-16s %-16s %14.2f %14.2f\n", setName, "GetRotation", single.minNsPerPose, single.medianNsPerPose);
+    printf("%-16s %-16s %14.2f %14.2f\n", setName, "GetRotations", batched.minNsPerPose, batched.medianNsPerPose);
+  }
+}
+
+// a controller waved around like a hand in use, sampled at c_controllerSampleRate, with the velocities the runtime would report for it
+static std::vector<vr::TrackedDevicePose_t> GetWavingControllerPoses(const int poseCount) {
+  const auto getPosition = [](const double t) -> vr::HmdVector3d_t {
+    return {0.3 * std::sin(1.3 * t), 1.1 + 0.2 * std::sin(2.1 * t), -0.3 + 0.25 * std::cos(0.9 * t)};
+  };
+  const auto getRotation = [](const double t) -> vr::HmdQuaternion_t {
+    const double angle = 2.5 * std::sin(0.8 * t) + 0.4 * std::sin(3.7 * t);
+    const double inclination = 1.7 * t;
+    const double azimuth = 0.6 * t;
+    const double sinHalfAngle = std::sin(angle * 0.5);
+
+    return {
+        std::cos(angle * 0.5),
+        std::sin(inclination) * std::cos(azimuth) * sinHalfAngle,
+        std::sin(inclination) * std::sin(azimuth) * sinHalfAngle,
+        std::cos(inclination) * sinHalfAngle};
+  };
+
+  // velocities by central differences
+  const double h = 1e-5;
+
+  std::vector<vr::TrackedDevicePose_t> result(poseCount);
+  uint32_t randomState = 0x9e3779b9u;
+  for (int i = 0; i < poseCount; i++) {
+    const double t = i / c_controllerSampleRate;
+    const vr::HmdQuaternion_t q = getRotation(t);
+
+    vr::TrackedDevicePose_t& pose = result[i];
+    pose = GetPose(q.w < 0.0 ? vr::HmdQuaternion_t{-q.w, -q.x, -q.y, -q.z} : q, randomState);
+
+    const vr::HmdVector3d_t position = getPosition(t);
+    const vr::HmdVector3d_t before = getPosition(t - h);
+    const vr::HmdVector3d_t after = getPosition(t + h);
+    for (int axis = 0; axis < 3; axis++) {
+      pose.mDeviceToAbsoluteTracking.m[axis][3] = static_cast<float>(position.v[axis]);
+      pose.vVelocity.v[axis] = static_cast<float>((after.v[axis] - before.v[axis]) / (2.0 * h));
+    }
+
+    // in world space, the angular velocity is the vector part of 2 dq/dt q*
+    const vr::HmdQuaternion_t qBefore = getRotation(t - h);
+    const vr::HmdQuaternion_t qAfter = getRotation(t + h);
+    const vr::HmdQuaternion_t dq = {
+        (qAfter.w - qBefore.w) / (2.0 * h),
+        (qAfter.x - qBefore.x) / (2.0 * h),
+        (qAfter.y - qBefore.y) / (2.0 * h),
+        (qAfter.z - qBefore.z) / (2.0 * h)};
+    pose.vAngularVelocity.v[0] = static_cast<float>(2.0 * (-dq.w * q.x + dq.x * q.w - dq.y * q.z + dq.z * q.y));
+    pose.vAngularVelocity.v[1] = static_cast<float>(2.0 * (-dq.w * q.y + dq.x * q.z + dq.y * q.w - dq.z * q.x));
+    pose.vAngularVelocity.v[2] = static_cast<float>(2.0 * (-dq.w * q.z - dq.x * q.y + dq.y * q.x + dq.z * q.w));
+  }
+
+  return result;
+}
+
+// controller poses recorded at c_controllerSampleRate one to a line, as the 12 floats of mDeviceToAbsoluteTracking row by row, then vVelocity
+// and vAngularVelocity
+static bool ReadRecording(const std::string& fileName, std::vector<vr::TrackedDevicePose_t>& result) {
+  std::ifstream file(fileName);
+  if (!file) return false;
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+
+    std::istringstream stream(line);
+    vr::TrackedDevicePose_t pose{};
+    for (auto& row : pose.mDeviceToAbsoluteTracking.m)
+      for (float& value : row) stream >> value;
+    for (float& value : pose.vVelocity.v) stream >> value;
+    for (float& value : pose.vAngularVelocity.v) stream >> value;
+
+    if (!stream) return false;
+
+    pose.bPoseIsValid = true;
+    pose.bDeviceIsConnected = true;
+    pose.eTrackingResult = vr::TrackingResult_Running_OK;
+    result.push_back(pose);
+  }
+
+  return !result.empty();
+}
+
+static vr::HmdQuaternion_t QuaternionProduct(const vr::HmdQuaternion_t& q, const vr::HmdQuaternion_t& r) {
+  return {
+      r.w * q.w - r.x * q.x - r.y * q.y - r.z * q.z,
+      r.w * q.x + r.x * q.w - r.y * q.z + r.z * q.y,
+      r.w * q.y + r.x * q.z + r.y * q.w - r.z * q.x,
+      r.w * q.z - r.x * q.y + r.y * q.x + r.z * q.w};
+}
+
+// v rotated by q, as q v q*
+static vr::HmdVector3d_t QuaternionRotate(const vr::HmdQuaternion_t& q, const vr::HmdVector3d_t& v) {
+  const vr::HmdQuaternion_t result = QuaternionProduct(QuaternionProduct(q, {0.0, v.v[0], v.v[1], v.v[2]}), {q.w, -q.x, -q.y, -q.z});
+
+  return {result.x, result.y, result.z};
+}
+
+// the rotation of a pose matrix in double, from the largest diagonal
+static vr::HmdQuaternion_t GetRotationInDouble(const vr::HmdMatrix34_t& matrix) {
+  double m[3][3];
+  for (int row = 0; row < 3; row++)
+    for (int column = 0; column < 3; column++) m[row][column] = matrix.m[row][column];
+
+  const double diagonals[4] = {
+      1.0 + m[0][0] + m[1][1] + m[2][2], 1.0 + m[0][0] - m[1][1] - m[2][2], 1.0 - m[0][0] + m[1][1] - m[2][2], 1.0 - m[0][0] - m[1][1] + m[2][2]};
+  const int largest = static_cast<int>(std::max_element(diagonals, diagonals + 4) - diagonals);
+
+  vr::HmdQuaternion_t q;
+  switch (largest) {
+    case 0:
+      q = {diagonals[0], m[2][1] - m[1][2], m[0][2] - m[2][0], m[1][0] - m[0][1]};
+      break;
+    case 1:
+      q = {m[2][1] - m[1][2], diagonals[1], m[0][1] + m[1][0], m[0][2] + m[2][0]};
+      break;
+    case 2:
+      q = {m[0][2] - m[2][0], m[0][1] + m[1][0], diagonals[2], m[1][2] + m[2][1]};
+      break;
+    default:
+      q = {m[1][0] - m[0][1], m[0][2] + m[2][0], m[1][2] + m[2][1], diagonals[3]};
+      break;
+  }
+
+  const double scale = std::copysign(0.5, q.w) / std::sqrt(diagonals[largest]);
+  return {q.w * scale, q.x * scale, q.y * scale, q.z * scale};
+}
+
+// the matrix of a rotation and translation in double
+static void GetMatrixInDouble(const vr::HmdQuaternion_t& q, const vr::HmdVector3d_t& translation, double (&result)[3][4]) {
+  const double w = q.w, x = q.x, y = q.y, z = q.z;
+
+  result[0][0] = 1.0 - 2.0 * (y * y + z * z);
+  result[0][1] = 2.0 * (x * y - w * z);
+  result[0][2] = 2.0 * (x * z + w * y);
+  result[1][0] = 2.0 * (x * y + w * z);
+  result[1][1] = 1.0 - 2.0 * (x * x + z * z);
+  result[1][2] = 2.0 * (y * z - w * x);
+  result[2][0] = 2.0 * (x * z - w * y);
+  result[2][1] = 2.0 * (y * z + w * x);
+  result[2][2] = 1.0 - 2.0 * (x * x + y * y);
+
+  for (int row = 0; row < 3; row++) result[row][3] = translation.v[row];
+}
+
+// largest difference between the components of two vectors, relative to the size of the expected vector where that's over 1
+static double GetVectorError(const vr::HmdVector3d_t& expected, const vr::HmdVector3d_t& actual) {
+  const double scale = std::max(1.0, std::sqrt(expected.v[0] * expected.v[0] + expected.v[1] * expected.v[1] + expected.v[2] * expected.v[2]));
+
+  return std::max({std::abs(expected.v[0] - actual.v[0]), std::abs(expected.v[1] - actual.v[1]), std::abs(expected.v[2] - actual.v[2])}) / scale;
+}
+
+struct PoseMathError {
+  double rotate = 0.0;
+  double inverseRotate = 0.0;
+  double product = 0.0;
+  double toMatrix = 0.0;
+  double getRotation = 0.0;
+};
+
+// compare the pose math in Util/SimdMath.h with doing the same in double precision, from the same float inputs, so that only the math itself
+// is measured. Vectors are up to a few metres (or metres per second), like positions and velocities in a room
+static bool CheckPoseMath() {
+  printf("\n%-16s %14s %14s %14s %14s %14s\n", "rotations", "Rotate", "InverseRotate", "product", "ToMat3x4f", "GetRotation");
+
+  const auto updateError = [](double& maxError, const double error) {
+    // NaN fails too
+    if (!(error <= maxError)) maxError = std::isnan(error) ? INFINITY : error;
+  };
+
+  bool passed = true;
+  for (const RotationSet set : c_rotationSets) {
+    uint32_t randomState = 0x2545f491u;
+    PoseMathError error;
+
+    for (int i = 0; i < c_mathSamples; i++) {
+      const Quatf q = ToQuatf(GetTestRotation(set, i, randomState));
+      const Quatf r = ToQuatf(GetTestRotation(RotationSet::Uniform, i, randomState));
+      const Vec3f v = ToVec3f(
+          vr::HmdVector3d_t{NextRandom(randomState) * 8.0 - 4.0, NextRandom(randomState) * 8.0 - 4.0, NextRandom(randomState) * 8.0 - 4.0});
+
+      // the float inputs the reference works from
+      const vr::HmdQuaternion_t qd = ToHmdQuaternion(q);
+      const vr::HmdQuaternion_t rd = ToHmdQuaternion(r);
+      const vr::HmdVector3d_t vd = ToHmdVector3d(v);
+
+      updateError(error.rotate, GetVectorError(QuaternionRotate(qd, vd), ToHmdVector3d(Rotate(q, v))));
+      updateError(error.inverseRotate, GetVectorError(QuaternionRotate({qd.w, -qd.x, -qd.y, -qd.z}, vd), ToHmdVector3d(InverseRotate(q, v))));
+
+      const vr::HmdQuaternion_t product = QuaternionProduct(qd, rd);
+      const vr::HmdQuaternion_t actualProduct = ToHmdQuaternion(q * r);
+      updateError(
+          error.product,
+          std::max(
+              {std::abs(product.w - actualProduct.w),
+               std::abs(product.x - actualProduct.x),
+               std::abs(product.y - actualProduct.y),
+               std::abs(product.z - actualProduct.z)}));
+
+      double expectedMatrix[3][4];
+      GetMatrixInDouble(qd, vd, expectedMatrix);
+      const vr::HmdMatrix34_t matrix = ToHmdMatrix34(ToMat3x4f(q, v));
+      for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 4; column++) {
+          const double expected = expectedMatrix[row][column];
+          updateError(error.toMatrix, std::abs(expected - matrix.m[row][column]) / std::max(1.0, std::abs(expected)));
+        }
+      }
+
+      // the rotation back out of the float matrix, against extracting it from the same matrix in double
+      updateError(error.getRotation, GetRotationError(GetRotationInDouble(matrix), GetRotation(matrix)));
+    }
+
+    printf(
+        "%-16s %14.3g %14.3g %14.3g %14.3g %14.3g\n",
+        GetRotationSetName(set),
+        error.rotate,
+        error.inverseRotate,
+        error.product,
+        error.toMatrix,
+        error.getRotation);
+
+    if (!(std::max({error.rotate, error.inverseRotate, error.product, error.toMatrix, error.getRotation}) <= c_mathTolerance)) {
+      printf("Pose math is off by more than %g from double precision on %s rotations\n", c_mathTolerance, GetRotationSetName(set));
+      passed = false;
+    }
+  }
+
+  printf("Pose math checked against double precision at %d samples for each set of rotations\n", c_mathSamples);
+
+  return passed;
+}
+
+// the glove pose the way UpdatePose used to build it, rotating each vector with two double quaternion products
+static vr::DriverPose_t ComposeWithQuaternionProducts(const vr::TrackedDevicePose_t& controllerPose, const VRPoseConfiguration& configuration) {
+  const vr::HmdMatrix34_t& controllerMatrix = controllerPose.mDeviceToAbsoluteTracking;
+
+  vr::DriverPose_t result = {0};
+  result.qDriverFromHeadRotation.w = 1;
+
+  const vr::HmdQuaternion_t controllerRotation = GetRotationInDouble(controllerMatrix);
+  const vr::HmdQuaternion_t inverseControllerRotation = {controllerRotation.w, -controllerRotation.x, -controllerRotation.y, -controllerRotation.z};
+  const vr::HmdQuaternion_t& offset = configuration.angleOffsetQuaternion;
+
+  result.qWorldFromDriverRotation = controllerRotation;
+  for (int axis = 0; axis < 3; axis++) {
+    result.vecWorldFromDriverTranslation[axis] = controllerMatrix.m[axis][3];
+    result.vecPosition[axis] = configuration.offsetVector.v[axis];
+  }
+
+  const vr::HmdVector3d_t velocity = {controllerPose.vVelocity.v[0], controllerPose.vVelocity.v[1], controllerPose.vVelocity.v[2]};
+  const vr::HmdVector3d_t angularVelocity = {
+      controllerPose.vAngularVelocity.v[0], controllerPose.vAngularVelocity.v[1], controllerPose.vAngularVelocity.v[2]};
+
+  const vr::HmdVector3d_t objectVelocity = QuaternionRotate(inverseControllerRotation, velocity);
+  const vr::HmdVector3d_t objectAngularVelocity =
+      QuaternionRotate({offset.w, -offset.x, -offset.y, -offset.z}, QuaternionRotate(inverseControllerRotation, angularVelocity));
+  std::copy_n(objectVelocity.v, 3, result.vecVelocity);
+  std::copy_n(objectAngularVelocity.v, 3, result.vecAngularVelocity);
+
+  result.qRotation = offset;
+
+  result.poseIsValid = true;
+  result.deviceIsConnected = true;
+  result.result = vr::TrackingResult_Running_OK;
+
+  return result;
+}
+
+// the glove pose PoseComposer should build, which adds the controller turning about the offset to the glove's velocity and dates the pose
+static vr::DriverPose_t ComposeWithLeverArm(
+    const vr::TrackedDevicePose_t& controllerPose, const VRPoseConfiguration& configuration, const double poseTimeOffset) {
+  vr::DriverPose_t result = ComposeWithQuaternionProducts(controllerPose, configuration);
+
+  const vr::HmdQuaternion_t& controllerRotation = result.qWorldFromDriverRotation;
+  const vr::HmdVector3d_t angularVelocity = QuaternionRotate(
+      {controllerRotation.w, -controllerRotation.x, -controllerRotation.y, -controllerRotation.z},
+      {controllerPose.vAngularVelocity.v[0], controllerPose.vAngularVelocity.v[1], controllerPose.vAngularVelocity.v[2]});
+  const double* offset = configuration.offsetVector.v;
+
+  result.vecVelocity[0] += angularVelocity.v[1] * offset[2] - angularVelocity.v[2] * offset[1];
+  result.vecVelocity[1] += angularVelocity.v[2] * offset[0] - angularVelocity.v[0] * offset[2];
+  result.vecVelocity[2] += angularVelocity.v[0] * offset[1] - angularVelocity.v[1] * offset[0];
+  result.poseTimeOffset = poseTimeOffset;
+
+  return result;
+}
+
+// largest difference between two poses, relative to the size of each value where that's over 1
+static double GetPoseError(const vr::DriverPose_t& expected, const vr::DriverPose_t& actual) {
+  double error = 0.0;
+  const auto compare = [&](const double a, const double b) { error = std::max(error, std::abs(a - b) / std::max(1.0, std::abs(a))); };
+
+  // either sign of a quaternion is the same rotation
+  const vr::HmdQuaternion_t& e = expected.qWorldFromDriverRotation;
+  const vr::HmdQuaternion_t& q = actual.qWorldFromDriverRotation;
+  const double sign = e.w * q.w + e.x * q.x + e.y * q.y + e.z * q.z < 0.0 ? -1.0 : 1.0;
+  compare(e.w, sign * q.w);
+  compare(e.x, sign * q.x);
+  compare(e.y, sign * q.y);
+  compare(e.z, sign * q.z);
+
+  compare(expected.qRotation.w, actual.qRotation.w);
+  compare(expected.qRotation.x, actual.qRotation.x);
+  compare(expected.qRotation.y, actual.qRotation.y);
+  compare(expected.qRotation.z, actual.qRotation.z);
+
+  for (int axis = 0; axis < 3; axis++) {
+    compare(expected.vecWorldFromDriverTranslation[axis], actual.vecWorldFromDriverTranslation[axis]);
+    compare(expected.vecPosition[axis], actual.vecPosition[axis]);
+    compare(expected.vecVelocity[axis], actual.vecVelocity[axis]);
+    compare(expected.vecAngularVelocity[axis], actual.vecAngularVelocity[axis]);
+  }
+
+  compare(expected.poseTimeOffset, actual.poseTimeOffset);
+
+  if (expected.poseIsValid != actual.poseIsValid || expected.result != actual.result) return INFINITY;
+
+  return error;
+}
+
+// check PoseComposer against building the pose with double quaternion products
+static bool CheckComposition(const std::vector<vr::TrackedDevicePose_t>& poses, const VRPoseConfiguration& configuration) {
+  const PoseComposer composer(configuration);
+  const float poseTimeOffset = configuration.poseTimeOffset - static_cast<float>(c_replayPoseAge);
+
+  double error = 0.0;
+  for (const vr::TrackedDevicePose_t& pose : poses) {
+    const double poseError = GetPoseError(ComposeWithLeverArm(pose, configuration, poseTimeOffset), composer.Compose(pose, poseTimeOffset));
+
+    // NaN fails too
+    if (!(poseError <= error)) error = poseError;
+  }
+
+  printf("\nComposed poses: %zu checked, max error %g (tolerance %g)\n", poses.size(), error, c_poseTolerance);
+  if (!(error <= c_poseTolerance)) {
+    printf("PoseComposer differs from the double precision pose by %g\n", error);
+    return false;
+  }
+
+  return true;
+}
+
+static void TimeComposition(const std::vector<vr::TrackedDevicePose_t>& poses, const VRPoseConfiguration& configuration) {
+  const PoseComposer composer(configuration);
+  const float poseTimeOffset = configuration.poseTimeOffset - static_cast<float>(c_replayPoseAge);
+
+  // the driver keeps one pose a hand, so the results go round a few that stay in cache rather than filling memory with them
+  std::array<vr::DriverPose_t, 16> results;
+
+  const TimingResult products = Time(poses.size(), [&] {
+    for (size_t i = 0; i < poses.size(); i++) results[i % results.size()] = ComposeWithLeverArm(poses[i], configuration, poseTimeOffset);
+  });
+  const TimingResult composed = Time(poses.size(), [&] {
+    for (size_t i = 0; i < poses.size(); i++) results[i % results.size()] = composer.Compose(poses[i], poseTimeOffset);
+  });
+
+  // keep the poses alive, so the work that produced them can't be optimised away
+  volatile double sink = results[0].vecAngularVelocity[0];
+  (void)sink;
+
+  printf("\n%-24s %14s %14s\n", "composition", "min ns/pose", "med ns/pose");
+  printf("%-24s %14.2f %14.2f\n", "quaternion products", products.minNsPerPose, products.medianNsPerPose);
+  printf("%-24s %14.2f %14.2f\n", "PoseComposer", composed.minNsPerPose, composed.medianNsPerPose);
+}
+
+// the rotation about v by its length times time in radians
+static vr::HmdQuaternion_t RotationVectorToQuaternion(const double* v, const double time) {
+  const double angle = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]) * time;
+
+  // sin(angle / 2) / angle tends to 1/2 as the angle goes to 0
+  const double scale = std::abs(angle) > 1e-12 ? std::sin(0.5 * angle) / angle * time : 0.5 * time;
+  return {std::cos(0.5 * angle), v[0] * scale, v[1] * scale, v[2] * scale};
+}
+
+// the controller's pose carried on at its velocities for time seconds, as the runtime predicts a raw pose
+static vr::TrackedDevicePose_t PredictControllerPose(const vr::TrackedDevicePose_t& pose, const double time) {
+  const double angularVelocity[3] = {pose.vAngularVelocity.v[0], pose.vAngularVelocity.v[1], pose.vAngularVelocity.v[2]};
+
+  vr::TrackedDevicePose_t result = pose;
+  SetRotation(
+      Normalize(QuaternionProduct(RotationVectorToQuaternion(angularVelocity, time), GetRotationInDouble(pose.mDeviceToAbsoluteTracking))),
+      result.mDeviceToAbsoluteTracking);
+  for (int axis = 0; axis < 3; axis++)
+    result.mDeviceToAbsoluteTracking.m[axis][3] = static_cast<float>(pose.mDeviceToAbsoluteTracking.m[axis][3] + pose.vVelocity.v[axis] * time);
+
+  return result;
+}
+
+struct GlovePose {
+  vr::HmdVector3d_t position;
+  vr::HmdQuaternion_t rotation;
+};
+
+// where the runtime shows a published pose time seconds after the time it's dated, carrying it on at its velocities within the driver's
+// space, with the angular velocity in the glove's own
+static GlovePose GetShownPose(const vr::DriverPose_t& pose, const double time) {
+  vr::HmdVector3d_t position;
+  for (int axis = 0; axis < 3; axis++) position.v[axis] = pose.vecPosition[axis] + pose.vecVelocity[axis] * time;
+  const vr::HmdQuaternion_t rotation = QuaternionProduct(pose.qRotation, RotationVectorToQuaternion(pose.vecAngularVelocity, time));
+
+  GlovePose result;
+  result.position = QuaternionRotate(pose.qWorldFromDriverRotation, position);
+  for (int axis = 0; axis < 3; axis++) result.position.v[axis] += pose.vecWorldFromDriverTranslation[axis];
+  result.rotation = QuaternionProduct(pose.qWorldFromDriverRotation, rotation);
+
+  return result;
+}
+
+struct ReplayError {
+  double positionSum = 0.0;
+  double maxPosition = 0.0;
+  double angleSum = 0.0;
+  double maxAngle = 0.0;
+
+  void Add(const GlovePose& expected, const GlovePose& actual) {
+    const double dx = expected.position.v[0] - actual.position.v[0];
+    const double dy = expected.position.v[1] - actual.position.v[1];
+    const double dz = expected.position.v[2] - actual.position.v[2];
+    const double position = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+    const vr::HmdQuaternion_t& e = expected.rotation;
+    const vr::HmdQuaternion_t& q = actual.rotation;
+    const double angle = 2.0 * std::acos(std::min(1.0, std::abs(e.w * q.w + e.x * q.x + e.y * q.y + e.z * q.z)));
+
+    positionSum += position;
+    maxPosition = std::max(maxPosition, position);
+    angleSum += angle;
+    maxAngle = std::max(maxAngle, angle);
+  }
+
+  // mean speed in m/s, to turn the mean error into how far behind the glove is shown
+  void Print(const char* name, const size_t count, const double meanSpeed) const {
+    const double meanPosition = positionSum / count;
+    printf(
+        "%-24s %10.2f %10.2f %10.3f %10.3f %10.2f\n",
+        name,
+        meanPosition * 1e3,
+        maxPosition * 1e3,
+        RadToDeg(angleSum / count),
+        RadToDeg(maxAngle),
+        meanPosition / meanSpeed * 1e3);
+  }
+};
+
+// replay the controller's poses through the driver and the runtime's extrapolation, and compare where the glove is shown with where it was
+// then. Before is the glove's pose as it used to be published, taken from the latest pose and dated when it's published, with the velocity
+// of the controller rather than the glove
+static void ReplayPrediction(const std::vector<vr::TrackedDevicePose_t>& poses, const VRPoseConfiguration& configuration) {
+  const size_t shownSample = static_cast<size_t>(std::lround((c_replayPoseAge + c_replayDisplayLatency) * c_controllerSampleRate));
+  if (poses.size() <= shownSample + 1) return;
+
+  const PoseComposer composer(configuration);
+  const size_t count = poses.size() - shownSample;
+
+  ReplayError before;
+  ReplayError after[std::size(c_replayPredictionTimes)];
+  double speedSum = 0.0;
+  for (size_t i = 0; i < count; i++) {
+    const GlovePose expected = GetShownPose(ComposeWithQuaternionProducts(poses[i + shownSample], configuration), 0.0);
+    const GlovePose previous = GetShownPose(ComposeWithQuaternionProducts(poses[i + shownSample - 1], configuration), 0.0);
+    const double dx = expected.position.v[0] - previous.position.v[0];
+    const double dy = expected.position.v[1] - previous.position.v[1];
+    const double dz = expected.position.v[2] - previous.position.v[2];
+    speedSum += std::sqrt(dx * dx + dy * dy + dz * dz) * c_controllerSampleRate;
+
+    before.Add(expected, GetShownPose(ComposeWithQuaternionProducts(poses[i], configuration), c_replayDisplayLatency));
+
+    for (size_t j = 0; j < std::size(c_replayPredictionTimes); j++) {
+      const double predictionTime = c_replayPredictionTimes[j];
+      const vr::DriverPose_t published =
+          composer.Compose(PredictControllerPose(poses[i], predictionTime), static_cast<float>(predictionTime - c_replayPoseAge));
+      after[j].Add(expected, GetShownPose(published, c_replayDisplayLatency - published.poseTimeOffset));
+    }
+  }
+
+  const double meanSpeed = speedSum / count;
+  printf(
+      "\nPrediction replay: %zu poses, %.1f ms old when published and shown %.1f ms later, glove moving at %.2f m/s on average\n",
+      count,
+      c_replayPoseAge * 1e3,
+      c_replayDisplayLatency * 1e3,
+      meanSpeed);
+  printf("%-24s %10s %10s %10s %10s %10s\n", "shown pose", "mean mm", "max mm", "mean deg", "max deg", "lag ms");
+  before.Print("before", count, meanSpeed);
+  for (size_t j = 0; j < std::size(c_replayPredictionTimes); j++) {
+    const std::string name = "predicted to " + std::to_string(std::lround(c_replayPredictionTimes[j] * 1e3)) + " ms";
+    after[j].Print(name.c_str(), count, meanSpeed);
+  }
+}
+
+// a controller held still, sampled at c_controllerSampleRate, that only moves with the tracking's noise and reports the same velocities on
+// every update
+static std::vector<vr::TrackedDevicePose_t> GetStillControllerPoses(const int poseCount, const float velocity, const float angularVelocity) {
+  const vr::HmdQuaternion_t rotation = Normalize({0.9, 0.2, -0.3, 0.1});
+  const double position[3] = {0.2, 1.1, -0.4};
+
+  std::vector<vr::TrackedDevicePose_t> result(poseCount);
+  uint32_t randomState = 0x2545f491u;
+  for (int i = 0; i < poseCount; i++) {
+    vr::TrackedDevicePose_t& pose = result[i];
+    pose = GetPose(rotation, randomState);
+
+    for (int axis = 0; axis < 3; axis++) {
+      pose.mDeviceToAbsoluteTracking.m[axis][3] = static_cast<float>(position[axis] + (NextRandom(randomState) * 2.0 - 1.0) * c_stillNoise);
+      pose.vVelocity.v[axis] = velocity;
+      pose.vAngularVelocity.v[axis] = angularVelocity;
+    }
+  }
+
+  return result;
+}
+
+// the pose the runtime returns when it's fetched time seconds into the poses and predicted predictionTime on from then, which carries the
+// latest update on from when it was measured, so it moves on every fetch
+static vr::TrackedDevicePose_t FetchControllerPose(const std::vector<vr::TrackedDevicePose_t>& poses, const size_t update, const double time,
+    const double predictionTime) {
+  return PredictControllerPose(poses[update], time - update / c_controllerSampleRate + predictionTime);
+}
+
+struct UpdateDetection {
+  vr::TrackedDevicePose_t seenPose{};
+  double seenTime = 0.0;
+  size_t missed = 0;
+  size_t falseUpdates = 0;
+
+  // one poll, with the time the publisher notes for it, counting it against whether the controller really updated since the last
+  template <typename IsSame>
+  void Poll(const vr::TrackedDevicePose_t& pose, const double time, const bool updated, IsSame&& isSame) {
+    const bool changed = !isSame(seenPose, pose, static_cast<float>(time - seenTime));
+    if (updated && !changed) missed++;
+    if (!updated && changed) falseUpdates++;
+
+    if (changed) {
+      seenPose = pose;
+      seenTime = time;
+    }
+  }
+};
+
+// poll the controller through the runtime's prediction every c_detectionPollInterval, and count the updates PosePublisher::IsSamePose
+// misses, and the polls between updates it takes for one
+static bool CheckUpdateDetection(const std::vector<vr::TrackedDevicePose_t>& wavingPoses) {
+  struct Scenario {
+    const char* name;
+    std::vector<vr::TrackedDevicePose_t> poses;
+    double maxMissed;
+  };
+  const int stillPoseCount = static_cast<int>(std::max<size_t>(wavingPoses.size(), 2));
+  const Scenario scenarios[] = {
+      {"waving", wavingPoses, 0.0},
+      {"still", GetStillControllerPoses(stillPoseCount, 0.0f, 0.0f), c_maxMissedStillUpdates},
+      {"still, drifting", GetStillControllerPoses(stillPoseCount, c_stillDriftVelocity, c_stillDriftAngularVelocity), c_maxMissedStillUpdates},
+  };
+
+  // how the publisher used to tell updates apart, by the velocities and tracking state alone
+  const auto isSameVelocity = [](const vr::TrackedDevicePose_t& a, const vr::TrackedDevicePose_t& b, float) {
+    return std::memcmp(&a.vVelocity, &b.vVelocity, sizeof(a.vVelocity)) == 0 &&
+           std::memcmp(&a.vAngularVelocity, &b.vAngularVelocity, sizeof(a.vAngularVelocity)) == 0 && a.eTrackingResult == b.eTrackingResult &&
+           a.bPoseIsValid == b.bPoseIsValid && a.bDeviceIsConnected == b.bDeviceIsConnected;
+  };
+
+  printf(
+      "\nUpdate detection: polled every %.0f us at each replay prediction time, fetches up to %.0f us after they're noted\n",
+      c_detectionPollInterval * 1e6,
+      c_detectionFetchDelay * 1e6);
+  printf("%-24s %10s %10s %14s %14s %14s\n", "controller", "updates", "polls", "velocity only", "IsSamePose", "false updates");
+
+  bool passed = true;
+  for (const Scenario& scenario : scenarios) {
+    const double duration = scenario.poses.size() / c_controllerSampleRate;
+
+    size_t updates = 0;
+    size_t polls = 0;
+    UpdateDetection byVelocity;
+    UpdateDetection byPose;
+
+    for (const double predictionTime : c_replayPredictionTimes) {
+      byVelocity.seenPose = byPose.seenPose = {};
+
+      // the first poll sees the controller for the first time
+      uint32_t randomState = 0x68e31da4u;
+      size_t lastUpdate = scenario.poses.size();
+      for (double time = c_detectionPollInterval; time < duration; time += c_detectionPollInterval) {
+        const double fetchTime = time + NextRandom(randomState) * c_detectionFetchDelay;
+        const size_t update = std::min(static_cast<size_t>(fetchTime * c_controllerSampleRate), scenario.poses.size() - 1);
+        const vr::TrackedDevicePose_t pose = FetchControllerPose(scenario.poses, update, fetchTime, predictionTime);
+
+        const bool updated = update != lastUpdate;
+        lastUpdate = update;
+        updates += updated;
+        polls++;
+
+        byVelocity.Poll(pose, time, updated, isSameVelocity);
+        byPose.Poll(pose, time, updated, PosePublisher::IsSamePose);
+      }
+    }
+
+    printf("%-24s %10zu %10zu %14zu %14zu %14zu\n", scenario.name, updates, polls, byVelocity.missed, byPose.missed, byPose.falseUpdates);
+    if (byPose.missed > scenario.maxMissed * updates || byPose.falseUpdates != 0) {
+      printf(
+          "IsSamePose missed %zu of the %s controller's updates (up to %.0f allowed), and took %zu polls between updates for one\n",
+          byPose.missed,
+          scenario.name,
+          scenario.maxMissed * updates,
+          byPose.falseUpdates);
+      passed = false;
+    }
+  }
+
+  return passed;
+}
+
+static void PrintUsage(const char* program) {
+  fprintf(stderr, "Usage: %s [--poses <count>] [--recording <poses.txt>] [--skip-timing]\n", program);
+}
+
+int main(int argc, char** argv) {
+  int poseCount = c_defaultPoses;
+  std::string recordingFileName;
+  bool skipTiming = false;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string argument = argv[i];
+    const bool hasValue = i + 1 < argc;
+
+    if (argument == "--poses" && hasValue) {
+      poseCount = std::max(std::atoi(argv[++i]), 1);
+    } else if (argument == "--recording" && hasValue) {
+      recordingFileName = argv[++i];
+    } else if (argument == "--skip-timing") {
+      skipTiming = true;
+    } else {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  // the poses of a controller, recorded or made up, and the offset of a glove that's been calibrated at an angle to it
+  std::vector<vr::TrackedDevicePose_t> controllerPoses;
+  if (recordingFileName.empty()) {
+    controllerPoses = GetWavingControllerPoses(poseCount);
+  } else if (!ReadRecording(recordingFileName, controllerPoses)) {
+    fprintf(stderr, "Failed to read controller poses from %s\n", recordingFileName.c_str());
+    return 1;
+  }
+
+  const VRPoseConfiguration poseConfiguration = {
+      {-0.1, -0.08, -0.03}, EulerToQuaternion(DegToRad(20.0), DegToRad(-35.0), DegToRad(90.0)), -0.01f, -1, false, false, 500.0f, true};
+
+  bool passed = CheckRotations(poseCount);
+  passed = CheckPoseMath() && passed;
+  passed = CheckComposition(controllerPoses, poseConfiguration) && passed;
+  ReplayPrediction(controllerPoses, poseConfiguration);
+  passed = CheckUpdateDetection(controllerPoses) && passed;
+
+  if (skipTiming) return passed ? 0 : 1;
+
+  TimeRotations(poseCount);
+  TimeComposition(controllerPoses, poseConfiguration);
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,1318 @@
+#include <linux/perf_event.h>
+#include <malloc.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Bones.h"
+#include "DriverLog.h"
+#include "Util/AnimationBlob.h"
+#include "Util/Quaternion.h"
+
+// the loaders report through the driver log, which goes to the console here
+void DriverLog(const char* pchFormat, ...) {
+  va_list args;
+  va_start(args, pchFormat);
+  vfprintf(stderr, pchFormat, args);
+  va_end(args);
+
+  fprintf(stderr, "\n");
+}
+
+void DebugDriverLog(const char* pchFormat, ...) {}
+
+// every allocation the process makes is counted, so that allocations in the skeleton path show up per frame, along with the bytes still
+// allocated, so that what a model holds on to shows up after reconfiguring
+static std::atomic<size_t> allocationCount{0};
+static std::atomic<size_t> allocatedBytes{0};
+
+void* operator new(const size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* result = std::malloc(size == 0 ? 1 : size)) {
+    allocatedBytes.fetch_add(malloc_usable_size(result), std::memory_order_relaxed);
+    return result;
+  }
+
+  throw std::bad_alloc();
+}
+
+static void FreeCounted(void* pointer) {
+  if (pointer != nullptr) allocatedBytes.fetch_sub(malloc_usable_size(pointer), std::memory_order_relaxed);
+  std::free(pointer);
+}
+
+void* operator new[](const size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  FreeCounted(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  FreeCounted(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  FreeCounted(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+  FreeCounted(pointer);
+}
+
+static const int c_defaultFrames = 4096;
+static const int c_repetitions = 10;
+
+// times both hands' animators are recreated in --reconfigure, as the driver does for every settings change
+static const int c_defaultReconfigurations = 200;
+
+// frames in each golden sequence, and how often the skeleton is recorded along it
+static const int c_goldenFrames = 128;
+static const int c_goldenSnapshotInterval = 16;
+
+// largest difference in any component from the golden skeletons, once their rotations are normalized (see GetErrorFromLegacy), that still
+// passes. Baked animations only match the keyframes to within the bake error the loader accepts
+static const float c_goldenTolerance = 1e-4f;
+static const float c_bakedGoldenTolerance = 2e-3f;
+
+// frames of each sweep both hands are compared against the path before structure of arrays keyframes at, every bone of every frame. Once the
+// old path's rotations are normalized they are the same as nlerp's in exact arithmetic, so c_legacyTolerance only allows for float rounding,
+// in the splay rotation too. Baked animations are held to c_bakedGoldenTolerance instead
+static const int c_legacyCheckFrames = 1024;
+static const float c_legacyTolerance = 1e-5f;
+
+// resolutions the baked animation is compared against the keyframes at, along with any given with --bake, and how many points between each
+// pair of steps it's compared at
+static const int c_bakeCheckResolutions[] = {17, 65, 241, 256, 1024};
+static const int c_bakeCheckSamplesPerStep = 16;
+
+// random keyframe pairs per bone the interpolation kernel is checked with for each kind of pair, and the points between them it's checked at.
+// It must match a double precision nlerp to within c_nlerpTolerance. How far nlerp strays from slerp depends on how far apart the keyframes
+// are, so that's only bounded for pairs closer than c_slerpCheckMaxAngle, which is still far more than an animation moves between keyframes.
+// An exact nlerp strays up to 0.033 degrees from slerp there
+static const size_t c_interpolationCheckPairs = 1024;
+static const float c_interpolationCheckPoints[] = {0.0f, 0.125f, 0.25f, 0.5f, 0.75f, 0.875f, 1.0f};
+static const double c_nlerpTolerance = 1e-5;
+static const double c_slerpCheckMaxAngle = 30.0;
+static const double c_slerpTolerance = 0.05;
+
+// the animator quantizes input to this many steps per unit before comparing it with the last frame, so splay only ever takes the values of
+// this grid from -1 to 1 that the table is checked at. Its rotations must be within c_splayTableTolerance of building them from euler angles
+static const int c_splayQuantizationSteps = 4096;
+static const double c_splayTableTolerance = 1e-6;
+static const int c_splayTimingRepetitions = 200;
+
+// frames the slow curl sweep takes to close and open the hand, about 2 seconds at the rate gloves send at
+static const int c_slowCurlPeriod = 180;
+
+static const float c_pi = 3.14159265358979f;
+
+enum class Sweep {
+  // the same input every frame, which the animator should mostly skip
+  Static,
+  // every finger slowly curling and splaying, each a little behind the last
+  SlowCurl,
+  // every joint and splay jumping to a new random value every frame
+  RapidRandom,
+};
+
+static const Sweep c_sweeps[] = {Sweep::Static, Sweep::SlowCurl, Sweep::RapidRandom};
+
+static const char* GetSweepName(const Sweep sweep) {
+  switch (sweep) {
+    case Sweep::Static:
+      return "static";
+    case Sweep::SlowCurl:
+      return "slow_curl";
+    case Sweep::RapidRandom:
+      return "rapid_random";
+  }
+
+  return "unknown";
+}
+
+// xorshift, so that the random sweep is the same on every platform and standard library
+static float NextRandom(uint32_t& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+
+  return static_cast<float>(state >> 8) / static_cast<float>(1 << 24);
+}
+
+static void GetSweepInput(const Sweep sweep, const int frame, uint32_t& randomState, VRInputData& result) {
+  for (size_t finger = 0; finger < result.flexion.size(); finger++) {
+    switch (sweep) {
+      case Sweep::Static: {
+        result.flexion[finger].fill(0.5f);
+        result.splay[finger] = 0.0f;
+        break;
+      }
+
+      case Sweep::SlowCurl: {
+        const float phase = 2.0f * c_pi * (static_cast<float>(frame) / c_slowCurlPeriod - static_cast<float>(finger) * 0.1f);
+
+        result.flexion[finger].fill(0.5f - 0.5f * std::cos(phase));
+        result.splay[finger] = 0.5f * std::sin(phase);
+        break;
+      }
+
+      case Sweep::RapidRandom: {
+        for (float& joint : result.flexion[finger]) joint = NextRandom(randomState);
+        result.splay[finger] = NextRandom(randomState) * 2.0f - 1.0f;
+        break;
+      }
+    }
+  }
+}
+
+// a hardware counter for the calling thread, unavailable if the kernel or the container doesn't allow it
+class PerfCounter {
+ public:
+  PerfCounter(const uint32_t type, const uint64_t config) {
+    perf_event_attr attributes{};
+    attributes.type = type;
+    attributes.size = sizeof(perf_event_attr);
+    attributes.config = config;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    file_ = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+  }
+
+  ~PerfCounter() {
+    if (file_ >= 0) close(file_);
+  }
+
+  PerfCounter(const PerfCounter&) = delete;
+  PerfCounter& operator=(const PerfCounter&) = delete;
+
+  bool IsAvailable() const {
+    return file_ >= 0;
+  }
+
+  void Start() const {
+    if (file_ < 0) return;
+
+    ioctl(file_, PERF_EVENT_IOC_RESET, 0);
+    ioctl(file_, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  uint64_t Stop() const {
+    if (file_ < 0) return 0;
+
+    ioctl(file_, PERF_EVENT_IOC_DISABLE, 0);
+
+    uint64_t result = 0;
+    if (read(file_, &result, sizeof(result)) != sizeof(result)) return 0;
+
+    return result;
+  }
+
+ private:
+  int file_ = -1;
+};
+
+struct BenchmarkResult {
+  double minNsPerFrame;
+  double medianNsPerFrame;
+  double cacheMissesPerFrame;
+  double instructionsPerFrame;
+  double allocationsPerFrame;
+};
+
+static std::vector<VRInputData> GetSweepInputs(const Sweep sweep, const int frames) {
+  std::vector<VRInputData> result(frames);
+  uint32_t randomState = 0x9e3779b9u;
+  for (int frame = 0; frame < frames; frame++) GetSweepInput(sweep, frame, randomState, result[frame]);
+
+  return result;
+}
+
+// time computeFrame over every input, which writes the skeletons it's given
+template <typename ComputeFrame>
+static BenchmarkResult TimeFrames(
+    const std::vector<VRInputData>& inputs, vr::VRBoneTransform_t* skeleton, vr::VRBoneTransform_t* controllerSkeleton, ComputeFrame computeFrame) {
+  const int frames = static_cast<int>(inputs.size());
+
+  // once through first, so that the model and the inputs are in cache like they would be while running
+  for (const VRInputData& input : inputs) computeFrame(input);
+
+  const PerfCounter cacheMisses(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  const PerfCounter instructions(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+
+  std::vector<double> nsPerFrame;
+  uint64_t totalCacheMisses = 0;
+  uint64_t totalInstructions = 0;
+  size_t totalAllocations = 0;
+
+  for (int repetition = 0; repetition < c_repetitions; repetition++) {
+    const size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    cacheMisses.Start();
+    instructions.Start();
+    const auto start = std::chrono::steady_clock::now();
+
+    for (const VRInputData& input : inputs) computeFrame(input);
+
+    const auto end = std::chrono::steady_clock::now();
+    totalInstructions += instructions.Stop();
+    totalCacheMisses += cacheMisses.Stop();
+    totalAllocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+    nsPerFrame.push_back(std::chrono::duration<double, std::nano>(end - start).count() / frames);
+  }
+
+  // keep the skeletons alive, so the work that produced it can't be optimised away
+  volatile float sink = skeleton[NUM_BONES - 1].orientation.w + (controllerSkeleton ? controllerSkeleton[NUM_BONES - 1].orientation.w : 0.0f);
+  (void)sink;
+
+  std::sort(nsPerFrame.begin(), nsPerFrame.end());
+
+  const double measuredFrames = static_cast<double>(frames) * c_repetitions;
+
+  return {
+      nsPerFrame.front(),
+      nsPerFrame[nsPerFrame.size() / 2],
+      cacheMisses.IsAvailable() ? totalCacheMisses / measuredFrames : NAN,
+      instructions.IsAvailable() ? totalInstructions / measuredFrames : NAN,
+      totalAllocations / measuredFrames};
+}
+
+// controllerSkeleton is only computed if withController is set, as the driver does when it publishes both ranges
+static BenchmarkResult RunBenchmark(BoneAnimator& animator, const Sweep sweep, const bool rightHand, const int frames, const bool withController) {
+  const std::vector<VRInputData> inputs = GetSweepInputs(sweep, frames);
+
+  vr::VRBoneTransform_t skeleton[NUM_BONES];
+  vr::VRBoneTransform_t controllerSkeleton[NUM_BONES];
+  animator.LoadDefaultSkeletonByHand(skeleton, rightHand);
+  animator.LoadDefaultSkeletonByHand(controllerSkeleton, rightHand);
+
+  vr::VRBoneTransform_t* const controllerResult = withController ? controllerSkeleton : nullptr;
+  return TimeFrames(inputs, skeleton, controllerResult, [&](const VRInputData& input) {
+    animator.ComputeSkeletonTransforms(skeleton, controllerResult, input, rightHand);
+  });
+}
+
+// ComputeSkeletonTransforms as it was before keyframes were stored as structure of arrays: a heap block of interleaved keyframes per bone,
+// a keyframe search per bone, the splay rotation built from euler angles per bone and the left hand mirrored per bone, every frame. Kept so
+// the current path can be timed and checked against it on the same model, and to record the golden output from
+class LegacyAnimator {
+ public:
+  // nullptr if the model's keyframes can't be stored the old way, which only held linear keyframes
+  static std::unique_ptr<LegacyAnimator> Create(const AnimationModel& model) {
+    if (model.coefficientCount != 1) return nullptr;
+
+    std::unique_ptr<LegacyAnimator> result(new LegacyAnimator());
+    result->keyframeTimes_.assign(model.keyframeTimes.begin(), model.keyframeTimes.end());
+
+    const size_t set = AnimationModel::GetKeyframeSet(AnimationRange::WithoutController, true);
+    for (size_t bone = 0; bone < c_animationBoneCount; bone++) {
+      std::vector<Transform>& keyframes = result->keyframeTransforms_.emplace_back(model.keyframeTimes.size());
+      for (size_t keyframe = 0; keyframe < keyframes.size(); keyframe++) {
+        if (model.quantizedRotations.empty()) {
+          const float* rotation = model.GetKeyframeRotation(set, keyframe, bone);
+          std::copy(rotation, rotation + 4, keyframes[keyframe].rotation.begin());
+        } else {
+          const int16_t* rotation = model.GetQuantizedKeyframeRotation(set, keyframe, bone);
+          for (size_t i = 0; i < 4; i++) keyframes[keyframe].rotation[i] = static_cast<float>(rotation[i]) / c_rotationQuantizationScale;
+        }
+
+        const float* translation = model.GetKeyframeTranslation(set, keyframe, bone);
+        std::copy(translation, translation + 3, keyframes[keyframe].translation.begin());
+      }
+    }
+
+    return result;
+  }
+
+  void ComputeSkeletonTransforms(vr::VRBoneTransform_t* skeleton, const VRInputData& inputData, const bool rightHand) const {
+    for (size_t i = 1; i < NUM_BONES; i++) {
+      const HandSkeletonBone bone = static_cast<HandSkeletonBone>(i);
+      const int finger = GetFinger(bone);
+      if (finger < 0) continue;
+
+      SetTransformForBone(skeleton[i], bone, GetCurl(bone, finger, inputData), inputData.splay[finger], rightHand);
+    }
+  }
+
+  // whether the keyframes the bone is between for this input are in opposite hemispheres. This path lerped straight across them, through
+  // rotations far from unit length, where nlerp takes the short way round, so its rotation there isn't one the current path should match
+  bool CrossesHemispheres(const HandSkeletonBone bone, const VRInputData& inputData) const {
+    const int finger = GetFinger(bone);
+    if (finger < 0) return false;
+
+    const float curl = GetCurl(bone, finger, inputData);
+    if (curl < 0.0f || curl > 1.0f) return false;
+
+    size_t lower, upper;
+    GetKeyframes(curl, lower, upper);
+
+    const Transform& start = keyframeTransforms_[static_cast<size_t>(bone)][lower];
+    const Transform& end = keyframeTransforms_[static_cast<size_t>(bone)][upper];
+    return start.rotation[0] * end.rotation[0] + start.rotation[1] * end.rotation[1] + start.rotation[2] * end.rotation[2] +
+               start.rotation[3] * end.rotation[3] <
+           0.0f;
+  }
+
+ private:
+  static constexpr size_t c_fingerRootBones[] = {
+      static_cast<size_t>(HandSkeletonBone::Thumb0),
+      static_cast<size_t>(HandSkeletonBone::IndexFinger0),
+      static_cast<size_t>(HandSkeletonBone::MiddleFinger0),
+      static_cast<size_t>(HandSkeletonBone::RingFinger0),
+      static_cast<size_t>(HandSkeletonBone::PinkyFinger0)};
+
+  LegacyAnimator() = default;
+
+  static bool IsAuxBone(const HandSkeletonBone bone) {
+    return bone >= HandSkeletonBone::AuxThumb && bone <= HandSkeletonBone::AuxPinkyFinger;
+  }
+
+  static int GetFinger(const HandSkeletonBone bone) {
+    if (IsAuxBone(bone)) return static_cast<int>(bone) - static_cast<int>(HandSkeletonBone::AuxThumb);
+    if (bone < HandSkeletonBone::Thumb0 || bone > HandSkeletonBone::PinkyFinger3) return -1;
+    if (bone < HandSkeletonBone::IndexFinger0) return bone == HandSkeletonBone::Thumb3 ? -1 : 0;
+
+    const size_t offset = static_cast<size_t>(bone) - static_cast<size_t>(HandSkeletonBone::IndexFinger0);
+    return offset % 5 == 4 ? -1 : static_cast<int>(offset / 5) + 1;
+  }
+
+  static float GetCurl(const HandSkeletonBone bone, const int finger, const VRInputData& inputData) {
+    return IsAuxBone(bone) ? BoneAnimator::GetAverageCurlValue(inputData.flexion[finger])
+                           : inputData.flexion[finger][static_cast<size_t>(bone) - c_fingerRootBones[finger]];
+  }
+
+  void GetKeyframes(const float curl, size_t& lower, size_t& upper) const {
+    lower = std::upper_bound(keyframeTimes_.begin(), keyframeTimes_.end(), curl) - keyframeTimes_.begin() - 1;
+    upper = lower < keyframeTimes_.size() - 1 ? lower + 1 : lower;
+  }
+
+  static bool IsSplayableBone(const HandSkeletonBone bone) {
+    return bone == HandSkeletonBone::Thumb0 || bone == HandSkeletonBone::IndexFinger1 || bone == HandSkeletonBone::MiddleFinger1 ||
+           bone == HandSkeletonBone::RingFinger1 || bone == HandSkeletonBone::PinkyFinger1;
+  }
+
+  static void TransformLeftBone(vr::VRBoneTransform_t& transform, const HandSkeletonBone bone) {
+    switch (bone) {
+      case HandSkeletonBone::Root:
+        return;
+
+      case HandSkeletonBone::Thumb0:
+      case HandSkeletonBone::IndexFinger0:
+      case HandSkeletonBone::MiddleFinger0:
+      case HandSkeletonBone::RingFinger0:
+      case HandSkeletonBone::PinkyFinger0: {
+        const vr::HmdQuaternionf_t quat = transform.orientation;
+        transform.orientation = {-quat.x, quat.w, -quat.z, quat.y};
+        break;
+      }
+
+      case HandSkeletonBone::Wrist:
+      case HandSkeletonBone::AuxThumb:
+      case HandSkeletonBone::AuxIndexFinger:
+      case HandSkeletonBone::AuxMiddleFinger:
+      case HandSkeletonBone::AuxRingFinger:
+      case HandSkeletonBone::AuxPinkyFinger:
+        transform.orientation.y *= -1;
+        transform.orientation.z *= -1;
+        break;
+
+      default:
+        transform.position.v[1] *= -1;
+        transform.position.v[2] *= -1;
+    }
+
+    transform.position.v[0] *= -1;
+  }
+
+  void SetTransformForBone(vr::VRBoneTransform_t& transform, const HandSkeletonBone bone, const float curl, const float splay, const bool rightHand)
+      const {
+    if (curl < 0.0f || curl > 1.0f) return;
+
+    const size_t boneIndex = static_cast<size_t>(bone);
+    size_t lower, upper;
+    GetKeyframes(curl, lower, upper);
+
+    // copied out like the old per-bone animation data was
+    const Transform start = keyframeTransforms_[boneIndex][lower];
+    const Transform end = keyframeTransforms_[boneIndex][upper];
+    const float interp =
+        upper == lower ? 0.0f : std::clamp((curl - keyframeTimes_[lower]) / (keyframeTimes_[upper] - keyframeTimes_[lower]), 0.0f, 1.0f);
+
+    const auto lerp = [interp](const float a, const float b) { return a + interp * (b - a); };
+    transform.orientation = {
+        lerp(start.rotation[0], end.rotation[0]),
+        lerp(start.rotation[1], end.rotation[1]),
+        lerp(start.rotation[2], end.rotation[2]),
+        lerp(start.rotation[3], end.rotation[3])};
+    transform.position = {
+        lerp(start.translation[0], end.translation[0]),
+        lerp(start.translation[1], end.translation[1]),
+        lerp(start.translation[2], end.translation[2]),
+        1.0f};
+
+    if (splay >= -1.0f && splay <= 1.0f && IsSplayableBone(bone)) {
+      const vr::HmdQuaternion_t s = EulerToQuaternion(0.0, DegToRad(splay * static_cast<double>(c_maxSplayAngle)), 0.0);
+      const vr::HmdQuaternionf_t q = transform.orientation;
+      transform.orientation = {
+          static_cast<float>(q.w * s.w - q.x * s.x - q.y * s.y - q.z * s.z),
+          static_cast<float>(q.w * s.x + q.x * s.w + q.y * s.z - q.z * s.y),
+          static_cast<float>(q.w * s.y - q.x * s.z + q.y * s.w + q.z * s.x),
+          static_cast<float>(q.w * s.z + q.x * s.y - q.y * s.x + q.z * s.w)};
+    }
+
+    if (!rightHand) TransformLeftBone(transform, bone);
+  }
+
+  std::vector<float> keyframeTimes_;
+  std::vector<std::vector<Transform>> keyframeTransforms_;
+};
+
+static BenchmarkResult RunLegacyBenchmark(
+    const LegacyAnimator& animator, BoneAnimator& defaults, const Sweep sweep, const bool rightHand, const int frames) {
+  const std::vector<VRInputData> inputs = GetSweepInputs(sweep, frames);
+
+  vr::VRBoneTransform_t skeleton[NUM_BONES];
+  defaults.LoadDefaultSkeletonByHand(skeleton, rightHand);
+
+  return TimeFrames(inputs, skeleton, nullptr, [&](const VRInputData& input) { animator.ComputeSkeletonTransforms(skeleton, input, rightHand); });
+}
+
+static std::array<float, 7> GetTransformValues(const vr::VRBoneTransform_t& transform) {
+  return {
+      transform.orientation.w,
+      transform.orientation.x,
+      transform.orientation.y,
+      transform.orientation.z,
+      transform.position.v[0],
+      transform.position.v[1],
+      transform.position.v[2]};
+}
+
+struct GoldenEntry {
+  std::string sweep;
+  int rightHand;
+  int frame;
+  int bone;
+  std::array<float, 7> values;
+  // not written to the file, see LegacyAnimator::CrossesHemispheres
+  bool crossesHemispheres = false;
+};
+
+// the skeleton every c_goldenSnapshotInterval frames of each sweep, for each hand, from the current path or from the old one, which is what
+// the golden file holds
+static std::vector<GoldenEntry> RecordGolden(
+    BoneAnimator& rightAnimator, BoneAnimator& leftAnimator, const LegacyAnimator* legacyAnimator, const bool fromLegacy) {
+  std::vector<GoldenEntry> result;
+
+  for (const Sweep sweep : c_sweeps) {
+    for (const bool rightHand : {true, false}) {
+      BoneAnimator& animator = rightHand ? rightAnimator : leftAnimator;
+
+      vr::VRBoneTransform_t skeleton[NUM_BONES];
+      animator.LoadDefaultSkeletonByHand(skeleton, rightHand);
+
+      uint32_t randomState = 0x9e3779b9u;
+      for (int frame = 0; frame < c_goldenFrames; frame++) {
+        VRInputData input;
+        GetSweepInput(sweep, frame, randomState, input);
+
+        if (fromLegacy)
+          legacyAnimator->ComputeSkeletonTransforms(skeleton, input, rightHand);
+        else
+          animator.ComputeSkeletonTransforms(skeleton, nullptr, input, rightHand);
+
+        if (frame % c_goldenSnapshotInterval != c_goldenSnapshotInterval - 1) continue;
+
+        for (int bone = 0; bone < NUM_BONES; bone++) {
+          result.push_back(
+              {GetSweepName(sweep),
+               rightHand,
+               frame,
+               bone,
+               GetTransformValues(skeleton[bone]),
+               legacyAnimator != nullptr && legacyAnimator->CrossesHemispheres(static_cast<HandSkeletonBone>(bone), input)});
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
+static bool WriteGolden(const std::string& fileName, const std::vector<GoldenEntry>& entries) {
+  std::ofstream file(fileName, std::ios::trunc);
+  file << "# recorded from the path before structure of arrays keyframes, which lerped rotations without normalizing them\n";
+  file << "# sweep right_hand frame bone orientation_w orientation_x orientation_y orientation_z position_x position_y position_z\n";
+
+  char line[256];
+  for (const GoldenEntry& entry : entries) {
+    snprintf(line, sizeof(line), "%s %d %d %d", entry.sweep.c_str(), entry.rightHand, entry.frame, entry.bone);
+    file << line;
+
+    for (const float value : entry.values) {
+      snprintf(line, sizeof(line), " %.7f", value);
+      file << line;
+    }
+    file << "\n";
+  }
+
+  return static_cast<bool>(file);
+}
+
+static bool ReadGolden(const std::string& fileName, std::vector<GoldenEntry>& result) {
+  std::ifstream file(fileName);
+  if (!file) return false;
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+
+    std::istringstream stream(line);
+    GoldenEntry entry;
+    stream >> entry.sweep >> entry.rightHand >> entry.frame >> entry.bone;
+    for (float& value : entry.values) stream >> value;
+
+    if (!stream) return false;
+    result.push_back(entry);
+  }
+
+  return true;
+}
+
+// largest difference in any component from a transform the old path produced. It lerped rotations without normalizing them, so its rotation
+// is normalized first, which is all nlerp changes between keyframes in the same hemisphere. Where it crossed hemispheres only the position
+// is compared
+static float GetErrorFromLegacy(const std::array<float, 7>& legacy, const std::array<float, 7>& current, const bool crossesHemispheres) {
+  const float length = std::sqrt(legacy[0] * legacy[0] + legacy[1] * legacy[1] + legacy[2] * legacy[2] + legacy[3] * legacy[3]);
+
+  float error = 0.0f;
+  for (size_t component = crossesHemispheres ? 4 : 0; component < legacy.size(); component++) {
+    const float expected = component < 4 ? legacy[component] / length : legacy[component];
+    const float difference = std::abs(expected - current[component]);
+
+    // NaN fails too
+    if (!(difference <= error)) error = difference;
+  }
+
+  return error;
+}
+
+// compare against the golden skeletons, reporting the first few that differ
+static bool CheckGolden(const std::vector<GoldenEntry>& golden, const std::vector<GoldenEntry>& current, const float tolerance) {
+  if (golden.size() != current.size()) {
+    printf("Golden output has %zu entries, but %zu were recorded\n", golden.size(), current.size());
+    return false;
+  }
+
+  float maxError = 0.0f;
+  int failures = 0;
+  int rotationsSkipped = 0;
+
+  for (size_t i = 0; i < golden.size(); i++) {
+    const GoldenEntry& expected = golden[i];
+    const GoldenEntry& actual = current[i];
+
+    if (expected.sweep != actual.sweep || expected.rightHand != actual.rightHand || expected.frame != actual.frame || expected.bone != actual.bone) {
+      printf("Golden output is for a different sequence at entry %zu, update it with --update-golden\n", i);
+      return false;
+    }
+
+    const float error = GetErrorFromLegacy(expected.values, actual.values, actual.crossesHemispheres);
+    rotationsSkipped += actual.crossesHemispheres;
+
+    // NaN fails too
+    if (!(error <= tolerance) && failures++ < 10)
+      printf(
+          "Mismatch in %s %s hand frame %d bone %d: error %f\n",
+          actual.sweep.c_str(),
+          actual.rightHand ? "right" : "left",
+          actual.frame,
+          actual.bone,
+          error);
+
+    if (!(error <= maxError)) maxError = error;
+  }
+
+  printf(
+      "Golden output: %zu bones checked, max error %g (tolerance %g), %d mismatched, %d rotations between keyframes in opposite hemispheres "
+      "not compared\n",
+      golden.size(),
+      maxError,
+      tolerance,
+      failures,
+      rotationsSkipped);
+
+  return failures == 0;
+}
+
+// every bone of both hands, frame by frame along each sweep, against the path before structure of arrays keyframes from the same default
+// skeleton, reporting the first few that differ
+static bool CheckAgainstLegacy(BoneAnimator& rightAnimator, BoneAnimator& leftAnimator, const LegacyAnimator& legacyAnimator, const float tolerance) {
+  printf("\n%-14s %-6s %14s %16s %12s %10s\n", "sweep", "hand", "max error", "not compared", "mismatched", "result");
+
+  int failures = 0;
+  for (const Sweep sweep : c_sweeps) {
+    const std::vector<VRInputData> inputs = GetSweepInputs(sweep, c_legacyCheckFrames);
+
+    for (const bool rightHand : {true, false}) {
+      BoneAnimator& animator = rightHand ? rightAnimator : leftAnimator;
+
+      vr::VRBoneTransform_t skeleton[NUM_BONES];
+      vr::VRBoneTransform_t legacySkeleton[NUM_BONES];
+      animator.LoadDefaultSkeletonByHand(skeleton, rightHand);
+      animator.LoadDefaultSkeletonByHand(legacySkeleton, rightHand);
+
+      float maxError = 0.0f;
+      int rotationsSkipped = 0;
+      int handFailures = 0;
+
+      for (int frame = 0; frame < c_legacyCheckFrames; frame++) {
+        animator.ComputeSkeletonTransforms(skeleton, nullptr, inputs[frame], rightHand);
+        legacyAnimator.ComputeSkeletonTransforms(legacySkeleton, inputs[frame], rightHand);
+
+        for (int bone = 0; bone < NUM_BONES; bone++) {
+          const bool crossesHemispheres = legacyAnimator.CrossesHemispheres(static_cast<HandSkeletonBone>(bone), inputs[frame]);
+          const float error = GetErrorFromLegacy(GetTransformValues(legacySkeleton[bone]), GetTransformValues(skeleton[bone]), crossesHemispheres);
+          rotationsSkipped += crossesHemispheres;
+
+          // NaN fails too
+          if (!(error <= tolerance) && failures + handFailures++ < 10)
+            printf(
+                "Mismatch in %s %s hand frame %d bone %d: error %f\n", GetSweepName(sweep), rightHand ? "right" : "left", frame, bone, error);
+
+          if (!(error <= maxError)) maxError = error;
+        }
+      }
+
+      failures += handFailures;
+      printf(
+          "%-14s %-6s %14g %16d %12d %10s\n",
+          GetSweepName(sweep),
+          rightHand ? "right" : "left",
+          maxError,
+          rotationsSkipped,
+          handFailures,
+          handFailures == 0 ? "ok" : "FAILED");
+    }
+  }
+
+  printf(
+      "Both hands checked against the path before structure of arrays keyframes for %d frames of each sweep, tolerance %g, with rotations "
+      "between keyframes in opposite hemispheres not compared\n",
+      c_legacyCheckFrames,
+      tolerance);
+
+  return failures == 0;
+}
+
+static float GetMaxComponentError(const vr::VRBoneTransform_t& a, const vr::VRBoneTransform_t& b) {
+  return std::max(
+      {std::abs(a.orientation.w - b.orientation.w),
+       std::abs(a.orientation.x - b.orientation.x),
+       std::abs(a.orientation.y - b.orientation.y),
+       std::abs(a.orientation.z - b.orientation.z),
+       std::abs(a.position.v[0] - b.position.v[0]),
+       std::abs(a.position.v[1] - b.position.v[1]),
+       std::abs(a.position.v[2] - b.position.v[2])});
+}
+
+// largest difference between the baked and keyframed animation over every bone of both hands and both ranges, more densely than the loader
+// checks it when baking
+static float GetBakeError(const AnimationModel& model, const AnimationModel& baked) {
+  const int samples = (static_cast<int>(baked.keyframeTimes.size()) - 1) * c_bakeCheckSamplesPerStep;
+
+  std::vector<KeyframeInterval> intervals(c_animationBoneCount);
+  std::vector<KeyframeInterval> bakedIntervals(c_animationBoneCount);
+  std::vector<vr::VRBoneTransform_t> transforms(c_animationBoneCount * c_animationRangeCount);
+  std::vector<vr::VRBoneTransform_t> bakedTransforms(c_animationBoneCount * c_animationRangeCount);
+
+  float result = 0.0f;
+  for (int sample = 0; sample <= samples; sample++) {
+    const float f = static_cast<float>(sample) / static_cast<float>(samples);
+    std::fill(intervals.begin(), intervals.end(), model.GetKeyframeInterval(f));
+    std::fill(bakedIntervals.begin(), bakedIntervals.end(), baked.GetKeyframeInterval(f));
+
+    for (const bool rightHand : {true, false}) {
+      model.GetTransforms(intervals.data(), rightHand, transforms.data(), transforms.data() + c_animationBoneCount);
+      baked.GetTransforms(bakedIntervals.data(), rightHand, bakedTransforms.data(), bakedTransforms.data() + c_animationBoneCount);
+
+      for (size_t i = 0; i < transforms.size(); i++) {
+        const float error = GetMaxComponentError(transforms[i], bakedTransforms[i]);
+
+        // NaN fails too
+        if (!(error <= result)) result = std::isnan(error) ? INFINITY : error;
+      }
+    }
+  }
+
+  return result;
+}
+
+// bake the animation at each resolution, reporting the resolution the loader actually used (it rounds up to land on evenly spaced keyframes)
+// and how far the table is from the keyframes. A table the loader accepts must be within c_maxBakeError everywhere
+static bool CheckBakeError(const AnimationModel& model, const int bakeResolution) {
+  std::vector<int> resolutions(std::begin(c_bakeCheckResolutions), std::end(c_bakeCheckResolutions));
+  if (bakeResolution > 0 && std::find(resolutions.begin(), resolutions.end(), bakeResolution) == resolutions.end())
+    resolutions.push_back(bakeResolution);
+
+  printf("\n%-10s %-10s %14s %10s\n", "requested", "used", "max error", "result");
+
+  bool passed = true;
+  for (const int resolution : resolutions) {
+    const std::shared_ptr<AnimationModel> baked = BakeAnimationModel(model, resolution);
+    if (baked == nullptr) {
+      printf("%-10d %-10s %14s %10s\n", resolution, "-", "-", "rejected");
+      continue;
+    }
+
+    const float error = GetBakeError(model, *baked);
+    const bool withinBound = error <= c_maxBakeError;
+    passed &= withinBound;
+
+    printf("%-10d %-10zu %14g %10s\n", resolution, baked->keyframeTimes.size(), error, withinBound ? "ok" : "FAILED");
+  }
+
+  printf("Baked animations checked against the keyframes at %d points per step, bound %g\n", c_bakeCheckSamplesPerStep, c_maxBakeError);
+
+  return passed;
+}
+
+// the kinds of keyframe pair the interpolation kernel is checked with
+enum class RotationPair {
+  // both keyframes anywhere
+  Random,
+  // the end keyframe within a few degrees of the start, but stored as its negation, which the kernel has to flip to take the short way round
+  NearAntipodal,
+  // the end keyframe a few degrees apart from the start, like neighbouring keyframes of an animation
+  Close,
+};
+
+static const char* GetRotationPairName(const RotationPair pair) {
+  switch (pair) {
+    case RotationPair::Random:
+      return "random";
+    case RotationPair::NearAntipodal:
+      return "near_antipodal";
+    case RotationPair::Close:
+      return "close";
+  }
+
+  return "unknown";
+}
+
+using Quaterniond = std::array<double, 4>;
+
+static double Dot(const Quaterniond& a, const Quaterniond& b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+}
+
+static Quaterniond Normalize(const Quaterniond& q) {
+  const double length = std::sqrt(Dot(q, q));
+  return {q[0] / length, q[1] / length, q[2] / length, q[3] / length};
+}
+
+// uniformly distributed over every rotation
+static Quaterniond GetRandomRotation(uint32_t& randomState) {
+  const double u0 = NextRandom(randomState);
+  const double u1 = 2.0 * c_pi * NextRandom(randomState);
+  const double u2 = 2.0 * c_pi * NextRandom(randomState);
+
+  return {std::sqrt(u0) * std::cos(u2), std::sqrt(1.0 - u0) * std::sin(u1), std::sqrt(1.0 - u0) * std::cos(u1), std::sqrt(u0) * std::sin(u2)};
+}
+
+// q rotated by up to maxAngle degrees about a random axis
+static Quaterniond Perturb(const Quaterniond& q, const double maxAngle, uint32_t& randomState) {
+  const Quaterniond axis = Normalize({0.0, NextRandom(randomState) - 0.5, NextRandom(randomState) - 0.5, NextRandom(randomState) - 0.5});
+  const double halfAngle = 0.5 * maxAngle * NextRandom(randomState) * c_pi / 180.0;
+  const Quaterniond r = {std::cos(halfAngle), std::sin(halfAngle) * axis[1], std::sin(halfAngle) * axis[2], std::sin(halfAngle) * axis[3]};
+
+  return {
+      q[0] * r[0] - q[1] * r[1] - q[2] * r[2] - q[3] * r[3],
+      q[0] * r[1] + q[1] * r[0] + q[2] * r[3] - q[3] * r[2],
+      q[0] * r[2] - q[1] * r[3] + q[2] * r[0] + q[3] * r[1],
+      q[0] * r[3] + q[1] * r[2] - q[2] * r[1] + q[3] * r[0]};
+}
+
+// angle (in degrees) of the rotation between two unit quaternions. From the chord between them rather than the acos of their dot product, which
+// loses most of its precision for rotations close together
+static double GetRotationAngle(const Quaterniond& a, const Quaterniond& b) {
+  const double sign = Dot(a, b) < 0.0 ? -1.0 : 1.0;
+
+  double difference = 0.0;
+  double sum = 0.0;
+  for (size_t i = 0; i < 4; i++) {
+    difference += (a[i] - sign * b[i]) * (a[i] - sign * b[i]);
+    sum += (a[i] + sign * b[i]) * (a[i] + sign * b[i]);
+  }
+
+  return 4.0 * std::atan2(std::sqrt(difference), std::sqrt(sum)) * 180.0 / c_pi;
+}
+
+struct InterpolationError {
+  // largest difference in any component from the double nlerp, and in unit length
+  double nlerpError = 0.0;
+  double lengthError = 0.0;
+
+  // largest angle (in degrees) from the double slerp, over every pair and over pairs closer than c_slerpCheckMaxAngle
+  double slerpAngle = 0.0;
+  double closeSlerpAngle = 0.0;
+};
+
+// interpolate keyframe pairs of a given kind through AnimationModel::GetTransforms, which runs the same kernel the animator does, and compare
+// every rotation with shortest path nlerp and slerp done in double precision from the same stored keyframes
+static InterpolationError GetInterpolationError(const RotationPair pair, const bool quantized) {
+  // every bone of the right hand animates between its own pairs of keyframes, 2k and 2k + 1
+  const size_t keyframeCount = c_interpolationCheckPairs * 2;
+  const size_t set = AnimationModel::GetKeyframeSet(AnimationRange::WithoutController, true);
+
+  std::vector<float> keyframeTimes(keyframeCount);
+  for (size_t keyframe = 0; keyframe < keyframeCount; keyframe++) keyframeTimes[keyframe] = static_cast<float>(keyframe) / (keyframeCount - 1);
+
+  std::vector<float> keyframeData(AnimationModel::GetKeyframeDataSize(keyframeCount, 1, 1, quantized));
+  std::vector<int16_t> quantizedRotations(quantized ? AnimationModel::GetQuantizedRotationsSize(keyframeCount, 1) : 0);
+
+  // the keyframes as stored, which is what the reference interpolates between
+  std::vector<Quaterniond> storedRotations(keyframeCount * c_animationBoneCount);
+
+  uint32_t randomState = 0x2545f491u + static_cast<uint32_t>(pair) * 0x9e3779b9u;
+  for (size_t keyframe = 0; keyframe < keyframeCount; keyframe += 2) {
+    for (size_t bone = 0; bone < c_animationBoneCount; bone++) {
+      const Quaterniond start = GetRandomRotation(randomState);
+      Quaterniond end;
+
+      switch (pair) {
+        case RotationPair::Random:
+          end = GetRandomRotation(randomState);
+          break;
+        case RotationPair::NearAntipodal:
+          end = Perturb(start, 5.0, randomState);
+          for (double& component : end) component = -component;
+          break;
+        case RotationPair::Close:
+          end = Perturb(start, 15.0, randomState);
+          break;
+      }
+
+      for (size_t i = 0; i < 2; i++) {
+        const Quaterniond& rotation = i == 0 ? start : end;
+        Quaterniond& stored = storedRotations[(keyframe + i) * c_animationBoneCount + bone];
+
+        if (quantized) {
+          int16_t* destination = &quantizedRotations[AnimationModel::GetQuantizedRotationIndex(keyframeCount, set, keyframe + i, bone)];
+          for (size_t component = 0; component < 4; component++) {
+            destination[component] = static_cast<int16_t>(std::lround(rotation[component] * c_rotationQuantizationScale));
+            stored[component] = destination[component] / static_cast<double>(c_rotationQuantizationScale);
+          }
+        } else {
+          float* destination = &keyframeData[AnimationModel::GetKeyframeRotationIndex(keyframeCount, 1, set, keyframe + i, bone)];
+          for (size_t component = 0; component < 4; component++) {
+            destination[component] = static_cast<float>(rotation[component]);
+            stored[component] = destination[component];
+          }
+        }
+
+        float* translation = &keyframeData[AnimationModel::GetKeyframeTranslationIndex(keyframeCount, 1, quantized, set, keyframe + i, bone)];
+        translation[3] = 1.0f;
+      }
+    }
+  }
+
+  AnimationModel model;
+  model.keyframeTimes = keyframeTimes;
+  model.keyframeData = keyframeData;
+  model.quantizedRotations = quantizedRotations;
+
+  InterpolationError result;
+  std::vector<KeyframeInterval> intervals(c_animationBoneCount);
+  std::vector<vr::VRBoneTransform_t> transforms(c_animationBoneCount);
+
+  for (size_t keyframe = 0; keyframe < keyframeCount; keyframe += 2) {
+    for (const float interp : c_interpolationCheckPoints) {
+      std::fill(intervals.begin(), intervals.end(), KeyframeInterval{keyframe, keyframe + 1, interp});
+      model.GetTransforms(intervals.data(), true, transforms.data(), nullptr);
+
+      for (size_t bone = 0; bone < c_animationBoneCount; bone++) {
+        const vr::HmdQuaternionf_t& orientation = transforms[bone].orientation;
+        const Quaterniond actual = {orientation.w, orientation.x, orientation.y, orientation.z};
+
+        // quantized keyframes are a little off unit length, and the kernel only normalises once it has interpolated between them
+        const Quaterniond& storedStart = storedRotations[keyframe * c_animationBoneCount + bone];
+        Quaterniond storedEnd = storedRotations[(keyframe + 1) * c_animationBoneCount + bone];
+
+        // q and -q are the same rotation, take the short way round like the kernel does
+        if (Dot(storedStart, storedEnd) < 0.0)
+          for (double& component : storedEnd) component = -component;
+
+        Quaterniond nlerp;
+        for (size_t i = 0; i < 4; i++) nlerp[i] = storedStart[i] + interp * (storedEnd[i] - storedStart[i]);
+        nlerp = Normalize(nlerp);
+
+        const Quaterniond start = Normalize(storedStart);
+        const Quaterniond end = Normalize(storedEnd);
+        const double angle = 0.5 * GetRotationAngle(start, end) * c_pi / 180.0;
+
+        Quaterniond slerp = end;
+        if (angle > 1e-9) {
+          const double startWeight = std::sin((1.0 - interp) * angle) / std::sin(angle);
+          const double endWeight = std::sin(interp * angle) / std::sin(angle);
+          for (size_t i = 0; i < 4; i++) slerp[i] = startWeight * start[i] + endWeight * end[i];
+        }
+
+        for (size_t i = 0; i < 4; i++) result.nlerpError = std::max(result.nlerpError, std::abs(actual[i] - nlerp[i]));
+        result.lengthError = std::max(result.lengthError, std::abs(std::sqrt(Dot(actual, actual)) - 1.0));
+
+        const double slerpAngle = GetRotationAngle(Normalize(actual), slerp);
+        result.slerpAngle = std::max(result.slerpAngle, slerpAngle);
+        if (2.0 * angle * 180.0 / c_pi < c_slerpCheckMaxAngle) result.closeSlerpAngle = std::max(result.closeSlerpAngle, slerpAngle);
+      }
+    }
+  }
+
+  return result;
+}
+
+// check the kernel that interpolates bone rotations against double precision nlerp and slerp, for float and quantized keyframes
+static bool CheckInterpolation() {
+  printf("\n%-16s %-10s %14s %14s %16s %16s %10s\n", "pair", "rotations", "nlerp error", "length error", "slerp deg", "close slerp deg", "result");
+
+  bool passed = true;
+  for (const RotationPair pair : {RotationPair::Random, RotationPair::NearAntipodal, RotationPair::Close}) {
+    for (const bool quantized : {false, true}) {
+      const InterpolationError error = GetInterpolationError(pair, quantized);
+
+      // NaN fails too
+      const bool withinBound =
+          error.nlerpError <= c_nlerpTolerance && error.lengthError <= c_nlerpTolerance && error.closeSlerpAngle <= c_slerpTolerance;
+      passed &= withinBound;
+
+      printf(
+          "%-16s %-10s %14g %14g %16g %16g %10s\n",
+          GetRotationPairName(pair),
+          quantized ? "int16" : "float",
+          error.nlerpError,
+          error.lengthError,
+          error.slerpAngle,
+          error.closeSlerpAngle,
+          withinBound ? "ok" : "FAILED");
+    }
+  }
+
+  printf(
+      "Interpolated rotations checked at %zu keyframe pairs per bone, bound %g from nlerp and %g degrees from slerp for pairs within %g degrees\n",
+      c_interpolationCheckPairs,
+      c_nlerpTolerance,
+      c_slerpTolerance,
+      c_slerpCheckMaxAngle);
+
+  return passed;
+}
+
+// median time (in milliseconds) reconfigure takes, after once through to warm up
+template <typename Reconfigure>
+static double TimeReconfigurations(const int reconfigurations, Reconfigure reconfigure) {
+  reconfigure();
+
+  std::vector<double> ms;
+  for (int i = 0; i < reconfigurations; i++) {
+    const auto start = std::chrono::steady_clock::now();
+    reconfigure();
+    ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  }
+
+  std::sort(ms.begin(), ms.end());
+  return ms[ms.size() / 2];
+}
+
+// what recreating both hands' animators costs, as the driver does for every settings change, and what memory they hold. Compared with each
+// animator extracting its own copy of the model, as it did before models were shared
+static void RunReconfigurationBenchmark(const std::string& modelFileName, const int bakeResolution, const int reconfigurations) {
+  const auto loadAnimators = [&]() {
+    BoneAnimator rightAnimator(modelFileName, bakeResolution);
+    BoneAnimator leftAnimator(modelFileName, bakeResolution);
+  };
+
+  // nothing else holds the model, so the first animator loads it (from the precompiled animation if there is one) and the second shares it
+  const double coldMs = TimeReconfigurations(reconfigurations, loadAnimators);
+
+  double warmMs;
+  {
+    // another device holds the model, so both animators find it in the cache
+    GLTFModelManager holder(modelFileName, bakeResolution);
+    holder.Load();
+
+    warmMs = TimeReconfigurations(reconfigurations, loadAnimators);
+  }
+
+  const auto extractModel = [&]() {
+    std::shared_ptr<AnimationModel> model = LoadGLTFAnimationModel(modelFileName);
+    if (model != nullptr && bakeResolution > 0) {
+      if (std::shared_ptr<AnimationModel> baked = BakeAnimationModel(*model, bakeResolution)) model = std::move(baked);
+    }
+
+    return model;
+  };
+
+  const double separateMs = TimeReconfigurations(reconfigurations, [&]() {
+    extractModel();
+    extractModel();
+  });
+
+  printf("\n%-40s %14s\n", "reconfiguration (both hands)", "median ms");
+  printf("%-40s %14.3f\n", "shared, first load of the model", coldMs);
+  printf("%-40s %14.3f\n", "shared, model already held", warmMs);
+  printf("%-40s %14.3f\n", "each hand extracting its own model", separateMs);
+
+  const bool hasBlob = LoadAnimationBlob(GetAnimationBlobPath(modelFileName), modelFileName) != nullptr;
+  printf("First loads %s\n", hasBlob ? "map the precompiled animation" : "parse the model, as there's no precompiled animation for it");
+
+  // the precompiled animation is mapped rather than allocated, so it's file pages shared with every process mapping it
+  size_t sharedBytes;
+  {
+    const size_t allocatedBefore = allocatedBytes.load(std::memory_order_relaxed);
+    BoneAnimator rightAnimator(modelFileName, bakeResolution);
+    BoneAnimator leftAnimator(modelFileName, bakeResolution);
+    sharedBytes = allocatedBytes.load(std::memory_order_relaxed) - allocatedBefore;
+  }
+
+  size_t separateBytes;
+  {
+    const size_t allocatedBefore = allocatedBytes.load(std::memory_order_relaxed);
+    const std::shared_ptr<AnimationModel> rightModel = extractModel();
+    const std::shared_ptr<AnimationModel> leftModel = extractModel();
+    separateBytes = allocatedBytes.load(std::memory_order_relaxed) - allocatedBefore;
+  }
+
+  printf("\n%-40s %14s\n", "memory held (both hands)", "heap KiB");
+  printf("%-40s %14.1f\n", "shared", sharedBytes / 1024.0);
+  printf("%-40s %14.1f\n", "each hand extracting its own model", separateBytes / 1024.0);
+}
+
+// check BoneAnimator::GetSplayRotation against building the rotation from euler angles in double precision, as the animator did before it
+// had the table, at every quantized splay value, and time both
+static bool CheckSplayTable() {
+  std::vector<float> splays;
+  for (int step = -c_splayQuantizationSteps; step <= c_splayQuantizationSteps; step++)
+    splays.push_back(static_cast<float>(step) / static_cast<float>(c_splayQuantizationSteps));
+
+  double maxError = 0.0;
+  double maxLengthError = 0.0;
+  for (const float splay : splays) {
+    const vr::HmdQuaternionf_t actual = BoneAnimator::GetSplayRotation(splay);
+    const vr::HmdQuaternion_t expected = EulerToQuaternion(0.0, DegToRad(splay * static_cast<double>(c_maxSplayAngle)), 0.0);
+
+    // NaN fails too
+    for (const double error :
+         {std::abs(actual.w - expected.w), std::abs(actual.x - expected.x), std::abs(actual.y - expected.y), std::abs(actual.z - expected.z)})
+      if (!(error <= maxError)) maxError = std::isnan(error) ? INFINITY : error;
+
+    const double length = std::sqrt(
+        static_cast<double>(actual.w) * actual.w + static_cast<double>(actual.x) * actual.x + static_cast<double>(actual.y) * actual.y +
+        static_cast<double>(actual.z) * actual.z);
+    if (!(std::abs(length - 1.0) <= maxLengthError)) maxLengthError = std::isnan(length) ? INFINITY : std::abs(length - 1.0);
+  }
+
+  const auto timeSplays = [&](const auto getRotation) {
+    float sink = 0.0f;
+    const auto start = std::chrono::steady_clock::now();
+    for (int repetition = 0; repetition < c_splayTimingRepetitions; repetition++)
+      for (const float splay : splays) sink += getRotation(splay);
+    const auto end = std::chrono::steady_clock::now();
+
+    // keep the rotations alive, so the work that produced them can't be optimised away
+    volatile float result = sink;
+    (void)result;
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(splays.size()) * c_splayTimingRepetitions);
+  };
+
+  const double tableNs = timeSplays([](const float splay) { return BoneAnimator::GetSplayRotation(splay).y; });
+  const double eulerNs = timeSplays([](const float splay) {
+    return static_cast<float>(EulerToQuaternion(0.0, DegToRad(splay * static_cast<double>(c_maxSplayAngle)), 0.0).y);
+  });
+
+  const bool passed = maxError <= c_splayTableTolerance && maxLengthError <= c_splayTableTolerance;
+  printf(
+      "\nSplay table: %zu quantized splays checked, max error %g, max length error %g (tolerance %g), %s\n",
+      splays.size(),
+      maxError,
+      maxLengthError,
+      c_splayTableTolerance,
+      passed ? "ok" : "FAILED");
+  printf("Splay rotation: %.2f ns from the table, %.2f ns from euler angles\n", tableNs, eulerNs);
+
+  return passed;
+}
+
+static void PrintUsage(const char* program) {
+  fprintf(
+      stderr,
+      "Usage: %s [--model <model.glb>] [--bake <steps>] [--frames <count>] [--golden <file>] [--update-golden] [--skip-timing]\n"
+      "       %s [--model <model.glb>] [--bake <steps>] --reconfigure [<count>]\n",
+      program,
+      program);
+}
+
+int main(int argc, char** argv) {
+  std::string modelFileName = OPENGLOVE_BENCHMARK_MODEL;
+  std::string goldenFileName = OPENGLOVE_BENCHMARK_GOLDEN;
+  int bakeResolution = 0;
+  int frames = c_defaultFrames;
+  bool updateGolden = false;
+  bool skipTiming = false;
+  int reconfigurations = 0;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string argument = argv[i];
+    const bool hasValue = i + 1 < argc;
+
+    if (argument == "--model" && hasValue) {
+      modelFileName = argv[++i];
+    } else if (argument == "--golden" && hasValue) {
+      goldenFileName = argv[++i];
+    } else if (argument == "--bake" && hasValue) {
+      bakeResolution = std::atoi(argv[++i]);
+    } else if (argument == "--frames" && hasValue) {
+      frames = std::max(std::atoi(argv[++i]), 1);
+    } else if (argument == "--update-golden") {
+      updateGolden = true;
+    } else if (argument == "--skip-timing") {
+      skipTiming = true;
+    } else if (argument == "--reconfigure") {
+      reconfigurations = hasValue && std::atoi(argv[i + 1]) > 0 ? std::atoi(argv[++i]) : c_defaultReconfigurations;
+    } else {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  // before anything holds the model, so the first reconfiguration has to load it
+  if (reconfigurations > 0) {
+    RunReconfigurationBenchmark(modelFileName, bakeResolution, reconfigurations);
+    return 0;
+  }
+
+  // loaded models are cached for as long as a manager holds them, so the animators below share this one
+  GLTFModelManager modelManager(modelFileName, bakeResolution);
+  if (!modelManager.Load()) {
+    fprintf(stderr, "Failed to load animation from %s\n", modelFileName.c_str());
+    return 1;
+  }
+
+  // one animator for each hand, like one for each device in the driver
+  BoneAnimator rightAnimator(modelFileName, bakeResolution);
+  BoneAnimator leftAnimator(modelFileName, bakeResolution);
+
+  // the keyframed animation on its own, for the checks and timings that compare against it
+  const std::shared_ptr<AnimationModel> keyframedModel = LoadGLTFAnimationModel(modelFileName);
+  if (keyframedModel == nullptr) {
+    fprintf(stderr, "Failed to load keyframed animation from %s\n", modelFileName.c_str());
+    return 1;
+  }
+
+  const std::unique_ptr<LegacyAnimator> legacyAnimator = LegacyAnimator::Create(*keyframedModel);
+
+  bool passed = true;
+  if (updateGolden) {
+    // the golden output is what the path before structure of arrays keyframes produced, so that changes to the current one can't move it
+    if (legacyAnimator == nullptr) {
+      fprintf(stderr, "The path before structure of arrays keyframes only held linear keyframes, so it can't record %s\n", modelFileName.c_str());
+      return 1;
+    }
+
+    const std::vector<GoldenEntry> golden = RecordGolden(rightAnimator, leftAnimator, legacyAnimator.get(), true);
+    if (!WriteGolden(goldenFileName, golden)) {
+      fprintf(stderr, "Failed to write golden output to %s\n", goldenFileName.c_str());
+      return 1;
+    }
+
+    printf("Wrote %zu golden bones to %s\n", golden.size(), goldenFileName.c_str());
+  } else {
+    std::vector<GoldenEntry> golden;
+    if (!ReadGolden(goldenFileName, golden)) {
+      fprintf(stderr, "Failed to read golden output from %s\n", goldenFileName.c_str());
+      return 1;
+    }
+
+    const std::vector<GoldenEntry> current = RecordGolden(rightAnimator, leftAnimator, legacyAnimator.get(), false);
+    passed = CheckGolden(golden, current, bakeResolution > 0 ? c_bakedGoldenTolerance : c_goldenTolerance);
+  }
+
+  if (legacyAnimator != nullptr)
+    passed &= CheckAgainstLegacy(rightAnimator, leftAnimator, *legacyAnimator, bakeResolution > 0 ? c_bakedGoldenTolerance : c_legacyTolerance);
+  else
+    printf("\nThe path before structure of arrays keyframes only held linear keyframes, so the skeletons aren't checked against it\n");
+
+  passed &= CheckBakeError(*keyframedModel, bakeResolution);
+  passed &= CheckInterpolation();
+  passed &= CheckSplayTable();
+
+  if (skipTiming) return passed ? 0 : 1;
+
+  printf("\n%-14s %-6s %14s %14s %16s %16s %14s\n", "sweep", "hand", "min ns/frame", "med ns/frame", "misses/frame", "instr/frame", "allocs/frame");
+
+  for (const Sweep sweep : c_sweeps) {
+    for (const bool rightHand : {true, false}) {
+      const BenchmarkResult result = RunBenchmark(rightHand ? rightAnimator : leftAnimator, sweep, rightHand, frames, true);
+
+      printf(
+          "%-14s %-6s %14.1f %14.1f %16.2f %16.1f %14.3f\n",
+          GetSweepName(sweep),
+          rightHand ? "right" : "left",
+          result.minNsPerFrame,
+          result.medianNsPerFrame,
+          result.cacheMissesPerFrame,
+          result.instructionsPerFrame,
+          result.allocationsPerFrame);
+    }
+  }
+
+  // the old path only computed the range without a controller, so the current one is timed the same way for this comparison
+  if (legacyAnimator != nullptr) {
+    printf("\nWithout the controller range, against the path before structure of arrays keyframes\n");
+    printf(
+        "%-14s %-6s %14s %14s %16s %16s %10s\n", "sweep", "hand", "old ns/frame", "new ns/frame", "old misses/frame", "new misses/frame", "speedup");
+
+    for (const Sweep sweep : c_sweeps) {
+      for (const bool rightHand : {true, false}) {
+        BoneAnimator& animator = rightHand ? rightAnimator : leftAnimator;
+        const BenchmarkResult legacy = RunLegacyBenchmark(*legacyAnimator, animator, sweep, rightHand, frames);
+        const BenchmarkResult current = RunBenchmark(animator, sweep, rightHand, frames, false);
+
+        printf(
+            "%-14s %-6s %14.1f %14.1f %16.2f %16.2f %9.1fx\n",
+            GetSweepName(sweep),
+            rightHand ? "right" : "left",
+            legacy.minNsPerFrame,
+            current.minNsPerFrame,
+            legacy.cacheMissesPerFrame,
+            current.cacheMissesPerFrame,
+            legacy.minNsPerFrame / current.minNsPerFrame);
+      }
+    }
+  } else {
+    printf("\nThe path before structure of arrays keyframes only held linear keyframes, so it isn't timed for this model\n");
+  }
+
+  if (!PerfCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES).IsAvailable())
+    printf("\nPerformance counters are unavailable (check /proc/sys/kernel/perf_event_paranoid), misses and instructions show as nan\n");
+
+  return passed ? 0 : 1;
+}